@@ -0,0 +1,68 @@
+/*
+ * Workloads.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <boost/range/algorithm/find.hpp>
+
+#include <opencog/util/exceptions.h>
+
+#include "Workloads.h"
+
+namespace opencog {
+
+const std::vector<std::string> Workload::names =
+	{"deduction", "animals", "frog", "criminal"};
+
+Workload::Workload(AtomSpacePtr as, const std::string& name,
+                   size_t facts, size_t rules, unsigned seed)
+	: _eval(as)
+{
+	if (boost::find(names, name) == names.end())
+		throw RuntimeException(TRACE_INFO, "No such workload: %s",
+		                       name.c_str());
+
+	// frog is the animals scenario seen from the backward chainer
+	std::string scm_name = name == "frog" ? "animals" : name;
+
+	std::string source_dir = std::string(PROJECT_SOURCE_DIR),
+		binary_dir = std::string(PROJECT_BINARY_DIR);
+	for (const std::string& p : {source_dir,
+	                             source_dir + "/benchmarks/scm",
+	                             binary_dir + "/opencog/scm"})
+		_eval.eval("(add-to-load-path \"" + p + "\")");
+	_eval.eval("(use-modules (opencog))");
+	_eval.eval("(use-modules (opencog ure))");
+	_eval.eval("(load-from-path \"bench-workloads.scm\")");
+
+	Handle workload = _eval.eval_h("(bench-" + scm_name + " "
+	                               + std::to_string(facts) + " "
+	                               + std::to_string(rules) + " "
+	                               + std::to_string(seed) + ")");
+	if (_eval.eval_error() or not workload)
+		throw RuntimeException(TRACE_INFO, "Failed to generate workload %s",
+		                       name.c_str());
+
+	fc_rbs = workload->getOutgoingAtom(0);
+	bc_rbs = workload->getOutgoingAtom(1);
+	source = workload->getOutgoingAtom(2);
+	target = workload->getOutgoingAtom(3);
+}
+
+} // ~namespace opencog
@@ -0,0 +1,73 @@
+/*
+ * Workloads.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_URE_WORKLOADS_H_
+#define _OPENCOG_URE_WORKLOADS_H_
+
+#include <string>
+#include <vector>
+
+#include <opencog/atomspace/AtomSpace.h>
+#include <opencog/guile/SchemeEval.h>
+
+namespace opencog
+{
+
+/**
+ * Synthetic workload of a given scale, generated in an atomspace by
+ * the scheme functions of benchmarks/scm/bench-workloads.scm.
+ *
+ * The workload consists of a knowledge-base of about facts atoms, and
+ * of a forward and a backward rule-base of rules rules each, padded
+ * with distractor rules if the scenario requires fewer rules.
+ */
+class Workload
+{
+public:
+	/**
+	 * Generate workload name in as. Throw a RuntimeException if there
+	 * is no such workload.
+	 */
+	Workload(AtomSpacePtr as, const std::string& name,
+	         size_t facts, size_t rules, unsigned seed);
+
+	/**
+	 * Names of the available workloads.
+	 */
+	static const std::vector<std::string> names;
+
+	// Rule-bases of the forward and backward chainers
+	Handle fc_rbs;
+	Handle bc_rbs;
+
+	// Source of the forward chainer
+	Handle source;
+
+	// Target of the backward chainer
+	Handle target;
+
+private:
+	SchemeEval _eval;
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_URE_WORKLOADS_H_
@@ -0,0 +1,193 @@
+;
+; Scalable synthetic workloads for ure-benchmark
+;
+; Each workload is a function taking the number of facts, the number
+; of rules and a random seed. It fills the current atomspace with a
+; knowledge-base of about that many facts, defines a forward and a
+; backward rule-base of that many rules, and returns
+;
+; (List fc-rbs bc-rbs source target)
+;
+; where source is the forward chainer source and target the backward
+; chainer target. Rules beyond those required by the scenario are
+; distractors over predicates absent from the knowledge-base, they
+; never fire but cost the chainers unification and selection.
+;
+; The scenarios are scaled up versions of those of the unit tests
+;
+; deduction: tests/ure/backwardchainer/scm/bc-transitive-closure.scm
+; animals:   tests/ure/forwardchainer/scm/animals.scm
+; criminal:  tests/ure/backwardchainer/scm/criminal.scm
+;
+
+(use-modules (srfi srfi-1))
+(use-modules (opencog))
+(use-modules (opencog exec))
+(use-modules (opencog ure))
+
+(load-from-path "tests/ure/rules/fc-deduction-rule.scm")
+(load-from-path "tests/ure/rules/bc-deduction-rule.scm")
+(load-from-path "tests/ure/rules/fuzzy-conjunction-introduction-rule.scm")
+(load-from-path "tests/ure/meta-rules/conditional-full-instantiation-meta-rule.scm")
+
+;;;;;;;;;;;
+;; Utils ;;
+;;;;;;;;;;;
+
+(define (bench-name prefix i)
+  (string-append prefix "-" (number->string i)))
+
+(define (bench-concept prefix i)
+  (Concept (bench-name prefix i)))
+
+;; Define a rule-base with the given rules, padded with distractor
+;; rules to reach n rules.
+(define (bench-define-rbs name rule-names n)
+  (let ((rbs (Concept name)))
+    (ure-add-rules rbs rule-names)
+    (for-each (lambda (i) (ure-add-rule-alias rbs (bench-distractor-rule i)))
+              (iota (max 0 (- n (length rule-names)))))
+    rbs))
+
+(define (bench-conclusion AC AB BC)
+  (cog-set-tv! AC (stv 1 1)))
+
+;; Define the i-th distractor rule, transitivity over a predicate
+;; absent from the knowledge-base, and return its alias.
+(define (bench-distractor-rule i)
+  (let* ((alias (DefinedSchema (bench-name "bench-distractor-rule" i)))
+         (P (Predicate (bench-name "bench-distractor" i)))
+         (A (Variable "$A"))
+         (B (Variable "$B"))
+         (C (Variable "$C"))
+         (AB (Evaluation P (List A B)))
+         (BC (Evaluation P (List B C)))
+         (AC (Evaluation P (List A C))))
+    (DefineLink
+      alias
+      (Bind
+        (VariableSet A B C)
+        (And (Present AB BC) (Not (Identical A C)))
+        (ExecutionOutput
+          (GroundedSchema "scm: bench-conclusion")
+          (List AC AB BC))))
+    alias))
+
+;;;;;;;;;;;;;;;
+;; Deduction ;;
+;;;;;;;;;;;;;;;
+
+;; Chain of about n/2 concepts, plus random shortcuts between them to
+;; reach about n inheritance links. The target requires 4 deductions.
+(define (bench-deduction n r seed)
+  (define state (seed->random-state seed))
+  (define m (max 6 (1+ (quotient n 2))))
+  (define (C i) (bench-concept "C" i))
+  (for-each (lambda (i) (Inheritance (stv 1 1) (C i) (C (1+ i))))
+            (iota (1- m)))
+  (for-each (lambda (k)
+              (let* ((i (random (- m 2) state))
+                     (j (+ i 2 (random (- m i 2) state))))
+                (Inheritance (stv 1 1) (C i) (C j))))
+            (iota (max 0 (- n (1- m)))))
+  (List
+    (bench-define-rbs "bench-deduction-fc-rbs" (list fc-deduction-rule-name) r)
+    (bench-define-rbs "bench-deduction-bc-rbs" (list bc-deduction-rule-name) r)
+    (Inheritance (C 0) (C 1))
+    (Inheritance (C 0) (C 5))))
+
+;;;;;;;;;;;;;
+;; Animals ;;
+;;;;;;;;;;;;;
+
+(define (bench-animal-implication p1 p2 c)
+  (ImplicationScope (stv 1 1)
+    (TypedVariable (Variable "$X") (Type "ConceptNode"))
+    (And
+      (Evaluation (Predicate p1) (Variable "$X"))
+      (Evaluation (Predicate p2) (Variable "$X")))
+    (Inheritance (Variable "$X") (Concept c))))
+
+(define (bench-color-implication c color)
+  (ImplicationScope (stv 1 1)
+    (TypedVariable (Variable "$X") (Type "ConceptNode"))
+    (Inheritance (Variable "$X") (Concept c))
+    (Inheritance (Variable "$X") (Concept color))))
+
+;; About n/2 animals, half frogs (croak and eat flies) and half
+;; canaries (chirp and sing). The target is whether the first frog is
+;; green.
+(define (bench-animals n r seed)
+  (define (A i) (bench-concept "animal" i))
+  (bench-animal-implication "croaks" "eats_flies" "Frog")
+  (bench-animal-implication "chirps" "sings" "Canary")
+  (bench-color-implication "Frog" "green")
+  (bench-color-implication "Canary" "yellow")
+  (for-each (lambda (i)
+              (let ((ps (if (even? i)
+                            (list "croaks" "eats_flies")
+                            (list "chirps" "sings"))))
+                (for-each (lambda (p) (Evaluation (stv 1 1) (Predicate p) (A i)))
+                          ps)))
+            (iota (max 1 (quotient n 2))))
+  (let ((rule-names (list conditional-full-instantiation-meta-rule-name
+                          fuzzy-conjunction-introduction-2ary-rule-name)))
+    (List
+      (bench-define-rbs "bench-animals-fc-rbs" rule-names r)
+      (bench-define-rbs "bench-animals-bc-rbs" rule-names r)
+      (Evaluation (Predicate "croaks") (A 0))
+      (Inheritance (A 0) (Concept "green")))))
+
+;;;;;;;;;;;;;;
+;; Criminal ;;
+;;;;;;;;;;;;;;
+
+;; About n/8 copies of the criminal scenario, each with its own
+;; seller, buyer and missile. The target asks for all criminals.
+(define (bench-criminal-copy i)
+  (define West (bench-concept "West" i))
+  (define Nono (bench-concept "Nono" i))
+  (define missile (bench-concept "missile" i))
+  (And (stv .99 .99)
+    (Inheritance (stv .99 .99) missile (Concept "missile"))
+    (Evaluation (stv .99 .99) (Predicate "own") (List Nono missile)))
+  (ImplicationScope (stv .99 .99)
+    (TypedVariable (Variable "$a") (Type "ConceptNode"))
+    (And
+      (Inheritance (Variable "$a") (Concept "missile"))
+      (Evaluation (Predicate "own") (List Nono (Variable "$a"))))
+    (Evaluation (Predicate "sell") (List West (Variable "$a") Nono)))
+  (Inheritance (stv .99 .99) West (Concept "American"))
+  (Evaluation (stv .99 .99) (Predicate "enemy_of") (List Nono (Concept "America"))))
+
+(define (bench-criminal n r seed)
+  (ImplicationScope (stv .99 .99)
+    (VariableList
+      (TypedVariable (Variable "$x") (Type "ConceptNode"))
+      (TypedVariable (Variable "$y") (Type "ConceptNode"))
+      (TypedVariable (Variable "$z") (Type "ConceptNode")))
+    (And
+      (Inheritance (Variable "$x") (Concept "American"))
+      (Inheritance (Variable "$y") (Concept "weapon"))
+      (Evaluation (Predicate "sell")
+        (List (Variable "$x") (Variable "$y") (Variable "$z")))
+      (Inheritance (Variable "$z") (Concept "hostile")))
+    (Inheritance (Variable "$x") (Concept "criminal")))
+  (ImplicationScope (stv .99 .99)
+    (TypedVariable (Variable "$b") (Type "ConceptNode"))
+    (Evaluation (Predicate "enemy_of") (List (Variable "$b") (Concept "America")))
+    (Inheritance (Variable "$b") (Concept "hostile")))
+  (Inheritance (stv .99 .99) (Concept "missile") (Concept "weapon"))
+  (for-each bench-criminal-copy (iota (max 1 (quotient n 8))))
+  (let ((rule-names (list conditional-full-instantiation-meta-rule-name
+                          bc-deduction-rule-name
+                          fuzzy-conjunction-introduction-1ary-rule-name
+                          fuzzy-conjunction-introduction-2ary-rule-name
+                          fuzzy-conjunction-introduction-3ary-rule-name
+                          fuzzy-conjunction-introduction-4ary-rule-name
+                          fuzzy-conjunction-introduction-5ary-rule-name)))
+    (List
+      (bench-define-rbs "bench-criminal-fc-rbs" rule-names r)
+      (bench-define-rbs "bench-criminal-bc-rbs" rule-names r)
+      (Inheritance (bench-concept "West" 0) (Concept "American"))
+      (Inheritance (Variable "$who") (Concept "criminal")))))
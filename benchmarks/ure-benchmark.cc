@@ -0,0 +1,239 @@
+/*
+ * ure-benchmark.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * Run a synthetic workload with the forward or backward chainer and
+ * print its performance measures as a JSON object, such as
+ *
+ * {"workload": "deduction", "chainer": "bc", "facts": 1000, ...,
+ *  "iterations_per_second": 812.4, "time_to_first_result": 0.0153,
+ *  "results_per_second": 40.2, "peak_rss_kb": 81236}
+ *
+ * The time to first result is null if there is no result, or if it
+ * cannot be measured (forward chaining with more than one job).
+ *
+ * Each run should take place in its own process, since the peak
+ * resident set size is that of the whole process.
+ *
+ * Usage: ure-benchmark [-w workload] [-c fc|bc] [-f facts] [-r rules]
+ *                      [-i iterations] [-s seed] [-j jobs] [-o file]
+ *        ure-benchmark -l
+ */
+
+#include <getopt.h>
+#include <sys/resource.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+#include <opencog/util/Logger.h>
+#include <opencog/util/RandGen.h>
+#include <opencog/atomspace/AtomSpace.h>
+#include <opencog/ure/URELogger.h>
+#include <opencog/ure/forwardchainer/ForwardChainer.h>
+#include <opencog/ure/backwardchainer/BackwardChainer.h>
+
+#include "Workloads.h"
+
+using namespace opencog;
+
+struct Options
+{
+	std::string workload = "deduction";
+	std::string chainer = "bc";
+	size_t facts = 1000;
+	size_t rules = 10;
+	int iterations = 100;
+	unsigned seed = 0;
+	int jobs = 1;
+	std::string output;
+};
+
+struct Measures
+{
+	int iterations = 0;
+	double seconds = 0.0;
+	double first_result_seconds = -1.0;
+	size_t results = 0;
+	long peak_rss_kb = 0;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds_since(const Clock::time_point& start)
+{
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static long peak_rss_kb()
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+static Measures run_fc(AtomSpace& as, const Workload& wl, const Options& opts)
+{
+	ForwardChainer fc(as, wl.fc_rbs, wl.source);
+	fc.get_config().set_maximum_iterations(opts.iterations);
+	fc.get_config().set_jobs(opts.jobs);
+
+	Measures ms;
+	std::once_flag first_result;
+	Clock::time_point start = Clock::now();
+	fc.set_result_callback([&](const Handle&) {
+			std::call_once(first_result, [&]() {
+					ms.first_result_seconds = seconds_since(start); });
+		});
+	fc.do_chain();
+	ms.seconds = seconds_since(start);
+	ms.iterations = fc.get_iteration();
+	ms.results = fc.get_results_set().size();
+	return ms;
+}
+
+static Measures run_bc(AtomSpace& as, const Workload& wl, const Options& opts)
+{
+	BackwardChainer bc(as, wl.bc_rbs, wl.target);
+	bc.get_config().set_maximum_iterations(opts.iterations);
+	bc.get_config().set_jobs(opts.jobs);
+
+	Measures ms;
+	std::once_flag first_result;
+	Clock::time_point start = Clock::now();
+	bc.set_result_callback([&](const Handle&) {
+			std::call_once(first_result, [&]() {
+					ms.first_result_seconds = seconds_since(start); });
+		});
+	bc.do_chain();
+	ms.seconds = seconds_since(start);
+	ms.iterations = bc.get_iteration();
+	ms.results = bc.get_results_set().size();
+	return ms;
+}
+
+static void print_json(std::ostream& out, const Options& opts,
+                       const Measures& ms)
+{
+	auto rate = [&](double n) { return 0 < ms.seconds ? n / ms.seconds : 0.0; };
+	out << "{\"workload\": \"" << opts.workload << "\""
+	    << ", \"chainer\": \"" << opts.chainer << "\""
+	    << ", \"facts\": " << opts.facts
+	    << ", \"rules\": " << opts.rules
+	    << ", \"seed\": " << opts.seed
+	    << ", \"jobs\": " << opts.jobs
+	    << ", \"iterations\": " << ms.iterations
+	    << ", \"seconds\": " << ms.seconds
+	    << ", \"iterations_per_second\": " << rate(ms.iterations)
+	    << ", \"time_to_first_result\": ";
+	if (ms.first_result_seconds < 0)
+		out << "null";
+	else
+		out << ms.first_result_seconds;
+	out << ", \"results\": " << ms.results
+	    << ", \"results_per_second\": " << rate(ms.results)
+	    << ", \"peak_rss_kb\": " << ms.peak_rss_kb
+	    << "}" << std::endl;
+}
+
+static void usage(const char* prog)
+{
+	std::cerr << "Usage: " << prog << " [OPTIONS]" << std::endl
+	          << "  -w, --workload NAME    workload to run (default deduction)" << std::endl
+	          << "  -c, --chainer fc|bc    chainer to run (default bc)" << std::endl
+	          << "  -f, --facts N          number of facts (default 1000)" << std::endl
+	          << "  -r, --rules N          number of rules (default 10)" << std::endl
+	          << "  -i, --iterations N     maximum number of iterations (default 100)" << std::endl
+	          << "  -s, --seed N           random seed (default 0)" << std::endl
+	          << "  -j, --jobs N           number of jobs (default 1)" << std::endl
+	          << "  -o, --output FILE      append the JSON measures to FILE" << std::endl
+	          << "  -l, --list             list the workloads" << std::endl
+	          << "  -h, --help             print this message" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	static const struct option long_options[] = {
+		{"workload", required_argument, 0, 'w'},
+		{"chainer", required_argument, 0, 'c'},
+		{"facts", required_argument, 0, 'f'},
+		{"rules", required_argument, 0, 'r'},
+		{"iterations", required_argument, 0, 'i'},
+		{"seed", required_argument, 0, 's'},
+		{"jobs", required_argument, 0, 'j'},
+		{"output", required_argument, 0, 'o'},
+		{"list", no_argument, 0, 'l'},
+		{"help", no_argument, 0, 'h'},
+		{0, 0, 0, 0}
+	};
+
+	Options opts;
+	int c;
+	while ((c = getopt_long(argc, argv, "w:c:f:r:i:s:j:o:lh",
+	                        long_options, nullptr)) != -1) {
+		switch (c) {
+		case 'w': opts.workload = optarg; break;
+		case 'c': opts.chainer = optarg; break;
+		case 'f': opts.facts = std::stoul(optarg); break;
+		case 'r': opts.rules = std::stoul(optarg); break;
+		case 'i': opts.iterations = std::stoi(optarg); break;
+		case 's': opts.seed = std::stoul(optarg); break;
+		case 'j': opts.jobs = std::stoi(optarg); break;
+		case 'o': opts.output = optarg; break;
+		case 'l':
+			for (const std::string& name : Workload::names)
+				std::cout << name << std::endl;
+			return 0;
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (opts.chainer != "fc" and opts.chainer != "bc") {
+		usage(argv[0]);
+		return 1;
+	}
+
+	// Logging would dominate the measures
+	logger().set_level(Logger::WARN);
+	ure_logger().set_level(Logger::WARN);
+	randGen().seed(opts.seed);
+
+	AtomSpacePtr as = createAtomSpace();
+	Workload wl(as, opts.workload, opts.facts, opts.rules, opts.seed);
+
+	Measures ms = opts.chainer == "fc" ? run_fc(*as, wl, opts)
+		: run_bc(*as, wl, opts);
+	ms.peak_rss_kb = peak_rss_kb();
+
+	if (opts.output.empty()) {
+		print_json(std::cout, opts, ms);
+	} else {
+		std::ofstream out(opts.output, std::ios::app);
+		print_json(out, opts, ms);
+	}
+	return 0;
+}
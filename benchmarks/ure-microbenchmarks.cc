@@ -0,0 +1,332 @@
+/*
+ * ure-microbenchmarks.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * Google Benchmark microbenchmarks of the primitives dominating the
+ * profiles of the chainers, so that their optimizations can be
+ * evaluated in isolation. Their fixtures are built from the deduction
+ * workload of benchmarks/scm/bench-workloads.scm.
+ *
+ * Usage: ure-microbenchmarks [--benchmark_filter=REGEX] ...
+ */
+
+#include <map>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include <opencog/util/Logger.h>
+#include <opencog/util/mt19937ar.h>
+#include <opencog/atoms/truthvalue/SimpleTruthValue.h>
+#include <opencog/ure/Rule.h>
+#include <opencog/ure/UREConfig.h>
+#include <opencog/ure/URELogger.h>
+#include <opencog/ure/BetaDistribution.h>
+#include <opencog/ure/ThompsonSampling.h>
+#include <opencog/ure/forwardchainer/SourceSet.h>
+#include <opencog/ure/backwardchainer/BIT.h>
+#include <opencog/ure/backwardchainer/ControlPolicy.h>
+
+#include "Workloads.h"
+
+using namespace opencog;
+
+namespace {
+
+// Deduction workload of 100 facts with a given number of rules, and
+// the configurations of its rule-bases.
+struct Fixture
+{
+	AtomSpacePtr as;
+	std::unique_ptr<Workload> workload;
+	std::unique_ptr<UREConfig> fc_config;
+	std::unique_ptr<UREConfig> bc_config;
+
+	RulePtr rule(const UREConfig& config, const std::string& name) const
+	{
+		for (const RulePtr& rule : config.get_rules())
+			if (rule->get_name() == name)
+				return rule;
+		return nullptr;
+	}
+};
+
+// Build fixtures on demand, once per number of rules
+Fixture& fixture(size_t rules)
+{
+	static std::map<size_t, Fixture> fixtures;
+	Fixture& fx = fixtures[rules];
+	if (not fx.as) {
+		fx.as = createAtomSpace();
+		fx.workload.reset(new Workload(fx.as, "deduction", 100, rules, 0));
+		fx.fc_config.reset(new UREConfig(*fx.as, fx.workload->fc_rbs));
+		fx.bc_config.reset(new UREConfig(*fx.as, fx.workload->bc_rbs));
+	}
+	return fx;
+}
+
+// Premise shapes: 0 grounded, 1 with a variable, 2 not unifiable
+Handle premise(AtomSpace& as, int shape)
+{
+	Handle C0 = as.add_node(CONCEPT_NODE, "C-0"),
+		C1 = as.add_node(CONCEPT_NODE, "C-1");
+	switch (shape) {
+	case 0:
+		return as.add_link(INHERITANCE_LINK, C0, C1);
+	case 1:
+		return as.add_link(INHERITANCE_LINK,
+		                   as.add_node(VARIABLE_NODE, "$X"), C1);
+	default:
+		return as.add_link(EVALUATION_LINK,
+		                   as.add_node(PREDICATE_NODE, "P"), C0);
+	}
+}
+
+TruthValueSeq random_tvs(size_t n)
+{
+	MT19937RandGen rng(0);
+	TruthValueSeq tvs;
+	for (size_t i = 0; i < n; i++)
+		tvs.push_back(createSimpleTruthValue(rng.randdouble(),
+		                                     rng.randdouble()));
+	return tvs;
+}
+
+HandleSet inheritance_links(AtomSpace& as, const std::string& prefix,
+                            size_t n)
+{
+	HandleSet links;
+	Handle top = as.add_node(CONCEPT_NODE, prefix);
+	for (size_t i = 0; i < n; i++)
+		links.insert(as.add_link(INHERITANCE_LINK,
+		                         as.add_node(CONCEPT_NODE,
+		                                     prefix + "-" + std::to_string(i)),
+		                         top));
+	return links;
+}
+
+// and-BITs with distinct single clause FCSs
+std::vector<AndBIT> andbits(AtomSpace& as, size_t n)
+{
+	std::vector<AndBIT> abs;
+	Handle X = as.add_node(VARIABLE_NODE, "$X");
+	for (const Handle& h : inheritance_links(as, "andbit", n)) {
+		Handle clause = as.add_link(INHERITANCE_LINK, X, h->getOutgoingAtom(0));
+		abs.emplace_back(as.add_link(BIND_LINK, X,
+		                             as.add_link(PRESENT_LINK, clause),
+		                             clause));
+	}
+	return abs;
+}
+
+} // ~namespace
+
+//////////
+// Rule //
+//////////
+
+static void BM_Rule_unify_source(benchmark::State& state)
+{
+	Fixture& fx = fixture(1);
+	RulePtr rule = fx.rule(*fx.fc_config, "fc-deduction-rule");
+	rule->premises_as_clauses = true;
+	Handle source = premise(*fx.as, state.range(0));
+	for (auto _ : state)
+		benchmark::DoNotOptimize(rule->unify_source(source));
+}
+BENCHMARK(BM_Rule_unify_source)->DenseRange(0, 2);
+
+static void BM_Rule_unify_target(benchmark::State& state)
+{
+	Fixture& fx = fixture(1);
+	RulePtr rule = fx.rule(*fx.bc_config, "bc-deduction-rule");
+	Handle target = premise(*fx.as, state.range(0));
+	for (auto _ : state)
+		benchmark::DoNotOptimize(rule->unify_target(target));
+}
+BENCHMARK(BM_Rule_unify_target)->DenseRange(0, 2);
+
+static void BM_RuleSet_insert(benchmark::State& state)
+{
+	const RuleSet& rules = fixture(state.range(0)).fc_config->get_rules();
+	for (auto _ : state) {
+		RuleSet rs;
+		for (const RulePtr& rule : rules)
+			rs.insert(rule);
+		benchmark::DoNotOptimize(rs);
+	}
+	state.SetItemsProcessed(state.iterations() * rules.size());
+}
+BENCHMARK(BM_RuleSet_insert)->RangeMultiplier(10)->Range(10, 1000);
+
+static void BM_RuleSet_find(benchmark::State& state)
+{
+	const RuleSet& rules = fixture(state.range(0)).fc_config->get_rules();
+	for (auto _ : state)
+		for (const RulePtr& rule : rules)
+			benchmark::DoNotOptimize(rules.find(rule));
+	state.SetItemsProcessed(state.iterations() * rules.size());
+}
+BENCHMARK(BM_RuleSet_find)->RangeMultiplier(10)->Range(10, 1000);
+
+//////////////////////
+// ThompsonSampling //
+//////////////////////
+
+static void BM_ThompsonSampling_distribution(benchmark::State& state)
+{
+	TruthValueSeq tvs = random_tvs(state.range(0));
+	ThompsonSampling ts(tvs);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(ts.distribution());
+}
+BENCHMARK(BM_ThompsonSampling_distribution)->RangeMultiplier(4)->Range(2, 128);
+
+static void BM_ThompsonSampling_select(benchmark::State& state)
+{
+	TruthValueSeq tvs = random_tvs(state.range(0));
+	ThompsonSampling ts(tvs);
+	MT19937RandGen rng(0);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(ts(rng));
+}
+BENCHMARK(BM_ThompsonSampling_select)->RangeMultiplier(4)->Range(2, 128);
+
+//////////////////////
+// BetaDistribution //
+//////////////////////
+
+static void BM_BetaDistribution_cdf(benchmark::State& state)
+{
+	BetaDistribution bd(createSimpleTruthValue(0.7, 0.5));
+	for (auto _ : state)
+		benchmark::DoNotOptimize(bd.cdf(state.range(0)));
+}
+BENCHMARK(BM_BetaDistribution_cdf)->RangeMultiplier(10)->Range(10, 1000);
+
+static void BM_BetaDistribution_sample(benchmark::State& state)
+{
+	BetaDistribution bd(createSimpleTruthValue(0.7, 0.5));
+	MT19937RandGen rng(0);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(bd(rng));
+}
+BENCHMARK(BM_BetaDistribution_sample);
+
+static void BM_mk_stv(benchmark::State& state)
+{
+	for (auto _ : state)
+		benchmark::DoNotOptimize(mk_stv(0.7, 0.01));
+}
+BENCHMARK(BM_mk_stv);
+
+///////////////
+// SourceSet //
+///////////////
+
+static void BM_SourceSet_insert(benchmark::State& state)
+{
+	Fixture& fx = fixture(1);
+	HandleSet products = inheritance_links(*fx.as, "product", state.range(0));
+	Source src(fx.workload->source);
+	for (auto _ : state) {
+		state.PauseTiming();
+		SourceSet sources(*fx.fc_config, fx.workload->source, Handle::UNDEFINED);
+		state.ResumeTiming();
+		sources.insert(products, src, 0.5);
+	}
+	state.SetItemsProcessed(state.iterations() * products.size());
+}
+BENCHMARK(BM_SourceSet_insert)->RangeMultiplier(10)->Range(10, 10000);
+
+static void BM_SourceSet_get_weights(benchmark::State& state)
+{
+	Fixture& fx = fixture(1);
+	HandleSet products = inheritance_links(*fx.as, "product", state.range(0));
+	SourceSet sources(*fx.fc_config, fx.workload->source, Handle::UNDEFINED);
+	sources.insert(products, Source(fx.workload->source), 0.5);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(sources.get_weights());
+}
+BENCHMARK(BM_SourceSet_get_weights)->RangeMultiplier(10)->Range(10, 10000);
+
+/////////
+// BIT //
+/////////
+
+static void BM_BIT_insert(benchmark::State& state)
+{
+	Fixture& fx = fixture(1);
+	std::vector<AndBIT> abs = andbits(*fx.as, state.range(0));
+	for (auto _ : state) {
+		state.PauseTiming();
+		BIT bit(*fx.as, fx.workload->target, Handle::UNDEFINED);
+		std::vector<AndBIT> copies(abs);
+		state.ResumeTiming();
+		for (AndBIT& andbit : copies)
+			bit.insert(andbit);
+	}
+	state.SetItemsProcessed(state.iterations() * abs.size());
+}
+BENCHMARK(BM_BIT_insert)->RangeMultiplier(10)->Range(10, 1000);
+
+static void BM_AndBIT_expand(benchmark::State& state)
+{
+	Fixture& fx = fixture(1);
+	BIT bit(*fx.as, fx.workload->target, Handle::UNDEFINED);
+	AndBIT* andbit = bit.init();
+	RulePtr rule = fx.rule(*fx.bc_config, "bc-deduction-rule");
+	RuleTypedSubstitutionMap rules = rule->unify_target(fx.workload->target);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(andbit->expand(fx.workload->target,
+		                                        *rules.begin()));
+}
+BENCHMARK(BM_AndBIT_expand);
+
+///////////////////
+// ControlPolicy //
+///////////////////
+
+static void BM_ControlPolicy_select_rule(benchmark::State& state)
+{
+	Fixture& fx = fixture(state.range(0));
+	BIT bit(*fx.as, fx.workload->target, Handle::UNDEFINED);
+	ControlPolicy control(*fx.bc_config, bit, fx.workload->target);
+	AndBIT* andbit = bit.init();
+	BITNode* bitleaf = andbit->select_leaf();
+	for (auto _ : state)
+		benchmark::DoNotOptimize(control.select_rule(*andbit, *bitleaf));
+}
+BENCHMARK(BM_ControlPolicy_select_rule)->RangeMultiplier(10)->Range(10, 1000);
+
+int main(int argc, char** argv)
+{
+	// Logging would dominate the measures
+	logger().set_level(Logger::WARN);
+	ure_logger().set_level(Logger::WARN);
+	randGen().seed(0);
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
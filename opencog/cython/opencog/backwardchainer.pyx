@@ -1,3 +1,4 @@
+import json
 from cython.operator cimport dereference as deref
 from opencog.atomspace cimport Atom
 from opencog.atomspace cimport cHandle, AtomSpace, TruthValue
@@ -51,6 +52,11 @@ cdef class BackwardChainer:
         cdef Atom result = Atom.createAtom(res_handle)
         return result
 
+    def get_stats(self):
+        """Return the profiling counters as a dict, only recorded if
+        URE:collect-stats is true."""
+        return json.loads(self.chainer.get_stats().to_json().decode('utf-8'))
+
     def __dealloc__(self):
         del self.chainer
         self._trace_as = None
@@ -1,3 +1,4 @@
+import json
 from opencog.atomspace import types
 from cython.operator cimport dereference as deref, preincrement as inc
 from opencog.atomspace cimport cHandle, Atom, AtomSpace, TruthValue
@@ -12,6 +13,7 @@ cdef class ForwardChainer:
     cdef cForwardChainer * chainer
     cdef AtomSpace _as
     cdef AtomSpace _trace_as
+    cdef size_t _results_cursor
     def __cinit__(self, AtomSpace _as,
                   Atom rbs,
                   Atom source,
@@ -38,6 +40,7 @@ cdef class ForwardChainer:
                                         handle_vector)
         self._as = _as
         self._trace_as = trace_as
+        self._results_cursor = 0
 
     def do_chain(self):
         return self.chainer.do_chain()
@@ -47,6 +50,31 @@ cdef class ForwardChainer:
         cdef Atom result = Atom.createAtom(res_handle)
         return result
 
+    def do_step(self):
+        self.chainer.do_step()
+
+    def termination(self):
+        return self.chainer.termination()
+
+    def get_new_results(self):
+        """Return the list of results produced since the previous call."""
+        cdef vector[cHandle] handles = self.chainer.get_new_results(self._results_cursor)
+        return [Atom.createAtom(h) for h in handles]
+
+    def stream_results(self):
+        """Chain step by step until termination, yielding the results
+        as soon as they are produced. Unlike do_chain, steps are run
+        in the calling thread, regardless of URE:jobs."""
+        while not self.chainer.termination():
+            self.chainer.do_step()
+            for result in self.get_new_results():
+                yield result
+
+    def get_stats(self):
+        """Return the profiling counters as a dict, only recorded if
+        URE:collect-stats is true."""
+        return json.loads(self.chainer.get_stats().to_json().decode('utf-8'))
+
     def __dealloc__(self):
         del self.chainer
         self._trace_as = None
@@ -1,9 +1,16 @@
+from libcpp cimport bool
 from libcpp.set cimport set
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 from opencog.atomspace cimport cHandle, cAtomSpace
 from opencog.logger cimport cLogger
 
 
+cdef extern from "opencog/ure/ChainerStats.h" namespace "opencog":
+    cdef cppclass cChainerStats "opencog::ChainerStats":
+        string to_json() const
+
+
 cdef extern from "opencog/ure/forwardchainer/ForwardChainer.h" namespace "opencog":
     cdef cppclass cForwardChainer "opencog::ForwardChainer":
         cForwardChainer(cAtomSpace& kb_as,
@@ -15,7 +22,11 @@ cdef extern from "opencog/ure/forwardchainer/ForwardChainer.h" namespace "openco
                         const vector[cHandle]& focus_set) except +
 
         void do_chain() except +
+        void do_step() except +
+        bool termination() except +
         cHandle get_results() const
+        vector[cHandle] get_new_results(size_t& cursor) const
+        const cChainerStats& get_stats() const
 
 
 cdef extern from "opencog/ure/backwardchainer/Fitness.h" namespace "opencog::BITNodeFitness":
@@ -70,6 +81,7 @@ cdef extern from "opencog/ure/backwardchainer/BackwardChainer.h" namespace "open
 
         void do_chain() except +
         cHandle get_results() const
+        const cChainerStats& get_stats() const
 
 
 cdef extern from "opencog/ure/URELogger.h" namespace "opencog":
@@ -33,6 +33,20 @@
 ;; -- ure-set-bc-maximum-bit-size -- Set the URE:BC:maximum-bit-size
 ;; -- ure-set-bc-mm-complexity-penalty -- Set the URE:BC:MM:complexity-penalty
 ;; -- ure-set-bc-mm-compressiveness -- Set the URE:BC:MM:compressiveness
+;; -- ure-set-bc-fulfillment-jobs -- Set the URE:BC:fulfillment-jobs parameter
+;; -- ure-set-bc-fulfillment-queue-size -- Set the URE:BC:fulfillment-queue-size parameter
+;; -- ure-set-bc-fulfillment-batch-size -- Set the URE:BC:fulfillment-batch-size parameter
+;; -- ure-set-bc-target-decomposition -- Set the URE:BC:target-decomposition parameter
+;; -- ure-set-bc-best-first -- Set the URE:BC:best-first parameter
+;; -- ure-set-bc-iterative-deepening -- Set the URE:BC:iterative-deepening parameter
+;; -- ure-set-bc-beam-width -- Set the URE:BC:beam-width parameter
+;; -- ure-set-bc-confidence-threshold -- Set the URE:BC:confidence-threshold parameter
+;; -- ure-set-bc-result-count -- Set the URE:BC:result-count parameter
+;; -- ure-set-bc-rule-pruning -- Set the URE:BC:rule-pruning parameter
+;; -- ure-set-subsumption-pruning -- Set the URE:subsumption-pruning parameter
+;; -- ure-set-collect-stats -- Set the URE:collect-stats parameter
+;; -- ure-set-fc-inference-record-limit -- Set the URE:FC:inference-record-limit parameter
+;; -- ure-set-bc-maximum-subtarget-instances -- Set the URE:BC:maximum-subtarget-instances parameter
 ;; -- ure-define-rbs -- Create a rbs that runs for a particular number of
 ;;                      iterations.
 ;; -- ure-logger-set-level! -- Set level of the URE logger
@@ -53,6 +67,9 @@
 ;; -- ure-logger-debug -- log at debug level of the URE logger
 ;; -- ure-logger-fine -- log at fine level of the URE logger
 ;; -- ure-logger-flush -- flush the URE logger
+;; -- ure-logger-set-async! -- set async flag of the URE logger
+;; -- ure-logger-set-async-buffer-size! -- set the per thread buffer size of the async URE logger
+;; -- ure-logger-get-async-dropped -- get the number of messages dropped by the async URE logger
 ;; -- bool->tv -- Convert #t to TRUE_TV and #f to FALSE_TV
 ;; -- tv->bool -- Convert TRUE_TV to #t, anything else to #f
 ;; -- confidence->count -- Convert Simple TV confidence to count
@@ -96,7 +113,10 @@
                  (jobs *unspecified*)
                  (expansion-pool-size *unspecified*)
                  (fc-retry-exhausted-sources *unspecified*)
-                 (fc-full-rule-application *unspecified*))
+                 (fc-full-rule-application *unspecified*)
+                 (subsumption-pruning *unspecified*)
+                 (collect-stats *unspecified*)
+                 (fc-inference-record-limit *unspecified*))
 "
   Forward Chainer call.
 
@@ -110,7 +130,10 @@
                  #:jobs jb
                  #:expansion-pool-size esp
                  #:fc-retry-exhausted-sources res
-                 #:fc-full-rule-application fra)
+                 #:fc-full-rule-application fra
+                 #:subsumption-pruning sp
+                 #:collect-stats cs
+                 #:fc-inference-record-limit irl)
 
   rbs: ConceptNode representing a rulebase.
 
@@ -155,6 +178,17 @@
        entire atomspace, not just the source. This can be convienient if
        the goal is to rapidly achieve inference closure.
 
+  sp: Flag indicating whether new sources (resp. and-BITs) that are
+      instances of existing ones, such as (Inheritance Fritz frog) given
+      (Inheritance $X frog), should be discarded.
+
+  cs: Whether per-phase counts, latencies and population sizes
+      are recorded, retrievable with cog-ure-stats.
+
+  irl: Maximum number of inference records kept in memory, the
+       oldest being discarded first. The results are kept regardless.
+       Negative means unbounded (default: -1).
+
   Note that the defaults of the optional arguments are not determined
   here (although they attempt to be documented here).  That is the case
   in order not to overwrite existing parameters set by
@@ -177,6 +211,12 @@
       (ure-set-fc-retry-exhausted-sources rbs fc-retry-exhausted-sources))
   (if (not (unspecified? fc-full-rule-application))
       (ure-set-fc-full-rule-application rbs fc-full-rule-application))
+  (if (not (unspecified? subsumption-pruning))
+      (ure-set-subsumption-pruning rbs subsumption-pruning))
+  (if (not (unspecified? collect-stats))
+      (ure-set-collect-stats rbs collect-stats))
+  (if (not (unspecified? fc-inference-record-limit))
+      (ure-set-fc-inference-record-limit rbs fc-inference-record-limit))
 
   ;; Defined optional atomspaces and call the forward chainer
   (let* ((trace-enabled (cog-atomspace? trace-as))
@@ -196,7 +236,20 @@
                  (expansion-pool-size *unspecified*)
                  (bc-maximum-bit-size *unspecified*)
                  (bc-mm-complexity-penalty *unspecified*)
-                 (bc-mm-compressiveness *unspecified*))
+                 (bc-mm-compressiveness *unspecified*)
+                 (bc-fulfillment-jobs *unspecified*)
+                 (bc-fulfillment-queue-size *unspecified*)
+                 (bc-fulfillment-batch-size *unspecified*)
+                 (bc-target-decomposition *unspecified*)
+                 (bc-best-first *unspecified*)
+                 (bc-iterative-deepening *unspecified*)
+                 (bc-beam-width *unspecified*)
+                 (bc-confidence-threshold *unspecified*)
+                 (bc-result-count *unspecified*)
+                 (bc-rule-pruning *unspecified*)
+                 (subsumption-pruning *unspecified*)
+                 (collect-stats *unspecified*)
+                 (bc-maximum-subtarget-instances *unspecified*))
 "
   Backward Chainer call.
 
@@ -212,7 +265,20 @@
                  #:expansion-pool-size esp
                  #:bc-maximum-bit-size mbs
                  #:bc-mm-complexity-penalty mcp
-                 #:bc-mm-compressiveness mc)
+                 #:bc-mm-compressiveness mc
+                 #:bc-fulfillment-jobs fj
+                 #:bc-fulfillment-queue-size fqs
+                 #:bc-fulfillment-batch-size fbs
+                 #:bc-target-decomposition td
+                 #:bc-best-first bf
+                 #:bc-iterative-deepening id
+                 #:bc-beam-width bw
+                 #:bc-confidence-threshold ct
+                 #:bc-result-count rc
+                 #:bc-rule-pruning rp
+                 #:subsumption-pruning sp
+                 #:collect-stats cs
+                 #:bc-maximum-subtarget-instances msi)
 
   rbs: ConceptNode representing a rulebase.
 
@@ -239,7 +305,10 @@
       depth.  Possible range is (-inf, +inf) but it's rarely necessary in
       practice to go outside of [-10, 10].
 
-  jb: [optional, default=1] Number of jobs to run in parallel.
+  jb: [optional, default=1] Number of jobs to run in parallel. If
+      greater than 1, then at each step, as many distinct and-BITs are
+      expanded and fulfilled in parallel, each expansion counting as an
+      iteration.
 
   esp: [optional, default=1] This parameter controls how much the
        expension pool is supposed to grow. The larger, the more choices
@@ -257,6 +326,65 @@
       control rules (how well a control rule can explain data outside of its
       context).
 
+  fj: [optional, default=0] Number of threads fulfilling and-BITs
+      asynchronously while the BIT keeps being expanded. 0 means that
+      and-BITs are fulfilled synchronously.
+
+  fqs: [optional, default=100] Maximum number of and-BITs pending
+       fulfillment when fj is greater than 0. Expansion blocks when
+       reached.
+
+  fbs: [optional, default=0] Number of and-BITs accumulated before
+       being fulfilled together. And-BITs sharing clauses are grouped
+       so that their common clauses are only matched once. 0 or 1
+       means that each and-BIT is fulfilled on its own.
+
+  td: [optional, default=#f] Whether a conjunctive target should be
+      decomposed. Conjuncts not sharing variables are solved
+      concurrently by sub-chainers, conjuncts sharing variables are
+      solved in dependency order, the groundings of the former ones
+      being substituted in the latter ones.
+
+  bf: [optional, default=#f] Whether and-BITs are selected for
+      expansion deterministically, by increasing complexity plus an
+      admissible estimate of the complexity left to reach a proof (A*),
+      rather than randomly sampled. The and-BITs removed when the BIT
+      is too large are the most costly ones.
+
+  id: [optional, default=#f] Whether and-BITs are selected for
+      expansion depth-first, amongst those with estimated cost within a
+      bound, the bound being raised to the next smallest cost once no
+      and-BIT is within it (IDA*). Takes precedence over best-first.
+
+  bw: [optional, default=0] If positive, enable beam search. At each
+      generation all and-BITs of the BIT are expanded once, in parallel
+      if jobs is greater than 1, then only the bw heaviest and-BITs are
+      kept. Supersedes maximum-bit-size.
+
+  ct: [optional, default=-1] If non-negative, terminate as soon as
+      rc results have a confidence greater than or equal to ct.
+      Negative disables that termination criterion.
+
+  rc: [optional, default=1] Number of results reaching the confidence
+      threshold ct after which backward chaining terminates. Ignored if
+      ct is negative.
+
+  rp: [optional, default=#f] Whether rules that cannot be grounded in
+      the knowledge-base, directly or via other rules, according to the
+      rule dependency graph, are discarded before chaining.
+
+  sp: Flag indicating whether new sources (resp. and-BITs) that are
+      instances of existing ones, such as (Inheritance Fritz frog) given
+      (Inheritance $X frog), should be discarded.
+
+  cs: Whether per-phase counts, latencies and population sizes
+      are recorded, retrievable with cog-ure-stats.
+
+  msi: [optional, default=8] Maximum number of instances of a conjunct,
+       given the groundings of the conjuncts solved before it, solved by
+       sub-chainers during target decomposition. Negative means
+       unlimited.
+
   Note that the defaults of the optional arguments are not determined
   here (although they attempt to be documented here).  That is the case
   in order not to overwrite existing parameters set by
@@ -281,6 +409,32 @@
       (ure-set-bc-mm-complexity-penalty rbs bc-mm-complexity-penalty))
   (if (not (unspecified? bc-mm-compressiveness))
       (ure-set-bc-mm-compressiveness rbs bc-mm-compressiveness))
+  (if (not (unspecified? bc-fulfillment-jobs))
+      (ure-set-bc-fulfillment-jobs rbs bc-fulfillment-jobs))
+  (if (not (unspecified? bc-fulfillment-queue-size))
+      (ure-set-bc-fulfillment-queue-size rbs bc-fulfillment-queue-size))
+  (if (not (unspecified? bc-fulfillment-batch-size))
+      (ure-set-bc-fulfillment-batch-size rbs bc-fulfillment-batch-size))
+  (if (not (unspecified? bc-target-decomposition))
+      (ure-set-bc-target-decomposition rbs bc-target-decomposition))
+  (if (not (unspecified? bc-best-first))
+      (ure-set-bc-best-first rbs bc-best-first))
+  (if (not (unspecified? bc-iterative-deepening))
+      (ure-set-bc-iterative-deepening rbs bc-iterative-deepening))
+  (if (not (unspecified? bc-beam-width))
+      (ure-set-bc-beam-width rbs bc-beam-width))
+  (if (not (unspecified? bc-confidence-threshold))
+      (ure-set-bc-confidence-threshold rbs bc-confidence-threshold))
+  (if (not (unspecified? bc-result-count))
+      (ure-set-bc-result-count rbs bc-result-count))
+  (if (not (unspecified? bc-rule-pruning))
+      (ure-set-bc-rule-pruning rbs bc-rule-pruning))
+  (if (not (unspecified? subsumption-pruning))
+      (ure-set-subsumption-pruning rbs subsumption-pruning))
+  (if (not (unspecified? collect-stats))
+      (ure-set-collect-stats rbs collect-stats))
+  (if (not (unspecified? bc-maximum-subtarget-instances))
+      (ure-set-bc-maximum-subtarget-instances rbs bc-maximum-subtarget-instances))
 
   ;; Defined optional atomspaces and call the backward chainer
   (let* ((trace-enabled (cog-atomspace? trace-as))
@@ -296,6 +450,60 @@
     Return the ure logger.
 ")
 
+(set-procedure-property! cog-ure-stats 'documentation
+"
+ cog-ure-stats
+    Return the profiling counters of the last forward or backward
+    chainer run, as a JSON string, with, for each phase of chaining,
+    its number of runs, total time in seconds and histogram of
+    latencies in logarithmic microsecond bins, as well as the size of
+    the population at each iteration.
+
+    The counters are only recorded if URE:collect-stats is true, for
+    instance
+
+    (cog-bc rbs target #:collect-stats #t)
+    (cog-ure-stats)
+")
+
+(set-procedure-property! cog-ure-portfolio-win-counts 'documentation
+"
+ cog-ure-portfolio-win-counts
+    Return the number of wins of each backward chainer portfolio
+    member, by name, across all portfolios run so far by this
+    process, as a JSON object string mapping each name to its number
+    of wins.
+")
+
+(set-procedure-property! cog-ure-fc-new-results 'documentation
+"
+ cog-ure-fc-new-results
+    Return the list of results produced, by the forward chainer
+    running or last run via cog-fc, since the previous call. Allows
+    to consume the results while the forward chainer is running, by
+    calling it from another thread, for instance
+
+    (define fc-thread (call-with-new-thread (lambda () (cog-fc rbs source))))
+    (cog-ure-fc-new-results)
+")
+
+(set-procedure-property! cog-ure-set-trace-file! 'documentation
+"
+ cog-ure-set-trace-file! FILENAME SAMPLING
+    Make the subsequent forward and backward chainer runs append their
+    inference traces to FILENAME, in a compact binary format, instead
+    of having to pass a trace atomspace. Only 1 in SAMPLING inference
+    records is written. An empty FILENAME disables it.
+
+    The file can be converted into trace atoms, as they would have
+    been recorded in the trace atomspace, with
+    scripts/ure/trace-to-scm.py, for instance
+
+    (cog-ure-set-trace-file! \"/tmp/ure.trace\" 1)
+    (cog-bc rbs target)
+    (cog-ure-set-trace-file! \"\" 1)
+")
+
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 ;; URE Configuration Helpers ;;
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
@@ -914,6 +1122,188 @@
 "
   (ure-set-num-parameter rbs "URE:BC:MM:compressiveness" value))
 
+(define (ure-set-bc-fulfillment-jobs rbs value)
+"
+  Set the URE:BC:fulfillment-jobs parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:BC:fulfillment-jobs\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:BC:fulfillment-jobs" value))
+
+(define (ure-set-bc-fulfillment-queue-size rbs value)
+"
+  Set the URE:BC:fulfillment-queue-size parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:BC:fulfillment-queue-size\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:BC:fulfillment-queue-size" value))
+
+(define (ure-set-bc-fulfillment-batch-size rbs value)
+"
+  Set the URE:BC:fulfillment-batch-size parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:BC:fulfillment-batch-size\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:BC:fulfillment-batch-size" value))
+
+(define (ure-set-bc-target-decomposition rbs value)
+"
+  Set the URE:BC:target-decomposition parameter of a given RBS
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:BC:target-decomposition\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:BC:target-decomposition" value))
+
+(define (ure-set-bc-best-first rbs value)
+"
+  Set the URE:BC:best-first parameter of a given RBS
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:BC:best-first\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:BC:best-first" value))
+
+(define (ure-set-bc-iterative-deepening rbs value)
+"
+  Set the URE:BC:iterative-deepening parameter of a given RBS
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:BC:iterative-deepening\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:BC:iterative-deepening" value))
+
+(define (ure-set-bc-beam-width rbs value)
+"
+  Set the URE:BC:beam-width parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:BC:beam-width\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:BC:beam-width" value))
+
+(define (ure-set-bc-confidence-threshold rbs value)
+"
+  Set the URE:BC:confidence-threshold parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:BC:confidence-threshold\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:BC:confidence-threshold" value))
+
+(define (ure-set-bc-result-count rbs value)
+"
+  Set the URE:BC:result-count parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:BC:result-count\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:BC:result-count" value))
+
+(define (ure-set-bc-rule-pruning rbs value)
+"
+  Set the URE:BC:rule-pruning parameter of a given RBS
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:BC:rule-pruning\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:BC:rule-pruning" value))
+
+(define (ure-set-subsumption-pruning rbs value)
+"
+  Set the URE:subsumption-pruning parameter of a given RBS
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:subsumption-pruning\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:subsumption-pruning" value))
+
+(define (ure-set-collect-stats rbs value)
+"
+  Set the URE:collect-stats parameter of a given RBS
+
+  EvaluationLink (stv value 1)
+    PredicateNode \"URE:collect-stats\"
+    rbs
+
+  If the provided value is a boolean, then it is automatically
+  converted into tv.
+"
+  (ure-set-fuzzy-bool-parameter rbs "URE:collect-stats" value))
+
+(define (ure-set-fc-inference-record-limit rbs value)
+"
+  Set the URE:FC:inference-record-limit parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:FC:inference-record-limit\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:FC:inference-record-limit" value))
+
+(define (ure-set-bc-maximum-subtarget-instances rbs value)
+"
+  Set the URE:BC:maximum-subtarget-instances parameter of a given RBS
+
+  ExecutionLink
+    SchemaNode \"URE:BC:maximum-subtarget-instances\"
+    rbs
+    NumberNode value
+
+  Delete any previous one if exists.
+"
+  (ure-set-num-parameter rbs "URE:BC:maximum-subtarget-instances" value))
+
 (define-public (ure-define-rbs rbs iteration)
 "
   Transforms the atom into a node that represents a rulebase and returns it.
@@ -1073,11 +1463,40 @@
 
 (define (ure-logger-flush)
 "
-  Wrapper around cog-logger-flush using (cog-ure-logger) as logger.
+  Write the pending messages of the asynchronous URE logger, if any,
+  then flush the URE logger.
 
   See (help cog-logger-flush) for more info.
 "
-  (cog-logger-flush (cog-ure-logger)))
+  (cog-ure-logger-flush))
+
+(define (ure-logger-set-async! enable)
+"
+  Enable or disable the asynchronous URE logger. When enabled,
+  messages logged by the chainers are pushed into per thread ring
+  buffers and written by a background thread, so that logging, for
+  instance at debug level, does not slow down the chainers as much.
+
+  When disabled, the pending messages are written before returning.
+"
+  (cog-ure-logger-set-async! enable))
+
+(define (ure-logger-set-async-buffer-size! size)
+"
+  Set the capacity, in number of messages, of the per thread ring
+  buffers of the asynchronous URE logger. Messages logged while the
+  buffer of their thread is full are dropped. Threads that have
+  already logged switch to a buffer of the new capacity at their next
+  message.
+"
+  (cog-ure-logger-set-async-buffer-size! size))
+
+(define (ure-logger-get-async-dropped)
+"
+  Return the number of messages dropped by the asynchronous URE
+  logger so far.
+"
+  (cog-ure-logger-get-async-dropped))
 
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 ;; Helpers for Implementing URE Rules ;;
@@ -1281,6 +1700,10 @@
           cog-fc
           cog-bc
           cog-ure-logger
+          cog-ure-stats
+          cog-ure-portfolio-win-counts
+          cog-ure-set-trace-file!
+          cog-ure-fc-new-results
           ure-define-add-rule
           ure-add-rule-alias
           ure-add-rule-name
@@ -1305,6 +1728,20 @@
           ure-set-bc-maximum-bit-size
           ure-set-bc-mm-complexity-penalty
           ure-set-bc-mm-compressiveness
+          ure-set-bc-fulfillment-jobs
+          ure-set-bc-fulfillment-queue-size
+          ure-set-bc-fulfillment-batch-size
+          ure-set-bc-target-decomposition
+          ure-set-bc-best-first
+          ure-set-bc-iterative-deepening
+          ure-set-bc-beam-width
+          ure-set-bc-confidence-threshold
+          ure-set-bc-result-count
+          ure-set-bc-rule-pruning
+          ure-set-subsumption-pruning
+          ure-set-collect-stats
+          ure-set-fc-inference-record-limit
+          ure-set-bc-maximum-subtarget-instances
           ure-define-rbs
           ure-get-forward-rule
           ure-logger-set-level!
@@ -1325,6 +1762,9 @@
           ure-logger-debug
           ure-logger-fine
           ure-logger-flush
+          ure-logger-set-async!
+          ure-logger-set-async-buffer-size!
+          ure-logger-get-async-dropped
           bool->tv
           tv->bool
           atom->number
@@ -0,0 +1,222 @@
+/*
+ * BidirectionalChainer.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <opencog/unify/Unify.h>
+
+#include "BidirectionalChainer.h"
+#include "URELogger.h"
+
+using namespace opencog;
+
+BidirectionalChainer::BidirectionalChainer(AtomSpace& kb_as,
+                                           AtomSpace& rb_as,
+                                           const Handle& rbs,
+                                           const Handle& source,
+                                           const Handle& target,
+                                           const Handle& source_vardecl,
+                                           const Handle& target_vardecl,
+                                           double bias)
+	: _fc(kb_as, rb_as, rbs, source, source_vardecl),
+	  _bc(kb_as, rb_as, rbs, target, target_vardecl),
+	  _bias(bias), _met_fulfillment_count(0), _fc_results_cursor(0)
+{
+	_fc.set_source_bias([this](const Handle& body) {
+			return unifies_with_leaves(body, Handle::UNDEFINED) ? _bias : 1.0;
+		});
+	_fc.set_rule_bias([this](const Rule& rule) {
+			return unifies_with_leaves(rule.get_conclusion(), rule.get_vardecl())
+				? _bias : 1.0;
+		});
+}
+
+ForwardChainer& BidirectionalChainer::get_forward_chainer()
+{
+	return _fc;
+}
+
+BackwardChainer& BidirectionalChainer::get_backward_chainer()
+{
+	return _bc;
+}
+
+void BidirectionalChainer::do_chain()
+{
+	ure_logger().debug("Start bidirectional chaining");
+
+	_fc.begin_chain();
+	_bc.begin_chain();
+	while (not termination())
+		do_step();
+	_bc.end_chain();
+	_fc.end_chain();
+
+	LAZY_URE_LOG_DEBUG << "Finished bidirectional chaining with results:"
+	                   << std::endl << oc_to_string(get_results_set());
+}
+
+void BidirectionalChainer::do_step()
+{
+	if (not _bc.termination()) {
+		_bc.do_step();
+		update_leaves();
+	}
+
+	if (not _fc.termination()) {
+		_fc.do_step();
+		meet();
+	}
+}
+
+bool BidirectionalChainer::termination()
+{
+	// The backward chainer terminates if answered (see
+	// URE:BC:confidence-threshold)
+	bool bc_terminated = _bc.termination();
+	if (bc_terminated and not _bc.get_results_set().empty() and
+	    0 <= _bc.get_config().get_confidence_threshold())
+		return true;
+	return bc_terminated and _fc.termination();
+}
+
+Handle BidirectionalChainer::get_results() const
+{
+	return _bc.get_results();
+}
+
+const HandleSet& BidirectionalChainer::get_results_set() const
+{
+	return _bc.get_results_set();
+}
+
+size_t BidirectionalChainer::get_met_fulfillment_count() const
+{
+	return _met_fulfillment_count;
+}
+
+void BidirectionalChainer::meet()
+{
+	HandleSet met_leaves;
+	for (const Handle& product : _fc.get_new_results(_fc_results_cursor)) {
+		_met_products[product->get_type()].push_back(product);
+		HandleSet leaves = unified_leaves(product, Handle::UNDEFINED, _leaves);
+		met_leaves.insert(leaves.begin(), leaves.end());
+	}
+	fulfill(met_leaves);
+}
+
+void BidirectionalChainer::update_leaves()
+{
+	HandlePairSeq leaves = _bc.get_leaves();
+	if (leaves == _leaves)
+		return;
+
+	HandleSet current;
+	for (const HandlePair& leaf : leaves)
+		current.insert(leaf.first);
+
+	// Keep the former leaves still in the BIT, in order, then append
+	// the new ones
+	HandleSet former;
+	HandlePairSeq kept_leaves;
+	for (const HandlePair& leaf : _leaves) {
+		former.insert(leaf.first);
+		if (current.find(leaf.first) != current.end())
+			kept_leaves.push_back(leaf);
+	}
+	if (kept_leaves.size() < _leaves.size())
+		_unifications.clear();
+	size_t begin = kept_leaves.size();
+	_leaves = kept_leaves;
+	for (const HandlePair& leaf : leaves)
+		if (former.find(leaf.first) == former.end())
+			_leaves.push_back(leaf);
+
+	// The products met so far may meet the new leaves as well. Only
+	// the products of the same root type as a leaf may unify with
+	// it, unless the leaf is a variable.
+	HandleSet met_leaves;
+	for (size_t i = begin; i < _leaves.size(); i++) {
+		const HandlePair& leaf = _leaves[i];
+		for (const auto& tp : _met_products) {
+			if (not may_unify(tp.second.front(), leaf.first))
+				continue;
+			for (const Handle& product : tp.second) {
+				Unify unify(product, leaf.first, Handle::UNDEFINED, leaf.second);
+				if (unify().is_satisfiable()) {
+					met_leaves.insert(leaf.first);
+					break;
+				}
+			}
+		}
+	}
+	fulfill(met_leaves);
+}
+
+void BidirectionalChainer::fulfill(const HandleSet& met_leaves)
+{
+	if (met_leaves.empty())
+		return;
+
+	size_t count = _bc.fulfill_andbits(met_leaves);
+	_met_fulfillment_count += count;
+	LAZY_URE_LOG_DEBUG << "Forward chaining products met "
+	                   << met_leaves.size() << " BIT leaves, fulfilled "
+	                   << count << " and-BITs";
+}
+
+bool BidirectionalChainer::unifies_with_leaves(const Handle& term,
+                                               const Handle& vardecl)
+{
+	std::pair<bool, size_t>& memo = _unifications[term];
+	if (not memo.first and memo.second < _leaves.size()) {
+		memo.first = not unified_leaves(term, vardecl, _leaves,
+		                                memo.second).empty();
+		memo.second = _leaves.size();
+	}
+	return memo.first;
+}
+
+HandleSet BidirectionalChainer::unified_leaves(const Handle& term,
+                                               const Handle& vardecl,
+                                               const HandlePairSeq& leaves,
+                                               size_t begin) const
+{
+	HandleSet unified;
+	for (size_t i = begin; i < leaves.size(); i++) {
+		const HandlePair& leaf = leaves[i];
+		if (not may_unify(term, leaf.first))
+			continue;
+		Unify unify(term, leaf.first, vardecl, leaf.second);
+		if (unify().is_satisfiable())
+			unified.insert(leaf.first);
+	}
+	return unified;
+}
+
+bool BidirectionalChainer::may_unify(const Handle& term, const Handle& leaf)
+{
+	// Variables and quotations may hide the actual root type
+	auto is_opaque = [](Type t) {
+		return t == VARIABLE_NODE or t == GLOB_NODE
+			or t == QUOTE_LINK or t == LOCAL_QUOTE_LINK;
+	};
+	Type tt = term->get_type(), lt = leaf->get_type();
+	return tt == lt or is_opaque(tt) or is_opaque(lt);
+}
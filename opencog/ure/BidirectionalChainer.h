@@ -0,0 +1,162 @@
+/*
+ * BidirectionalChainer.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_BIDIRECTIONALCHAINER_H_
+#define _OPENCOG_BIDIRECTIONALCHAINER_H_
+
+#include <map>
+#include <unordered_map>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "forwardchainer/ForwardChainer.h"
+#include "backwardchainer/BackwardChainer.h"
+
+namespace opencog
+{
+
+/**
+ * Combine forward chaining from a source and backward chaining toward
+ * a target, alternating their steps, so that they meet in the middle.
+ *
+ * After each forward chaining step, the new products are unified
+ * with the leaves of the BIT, and the and-BITs containing matching
+ * leaves are fulfilled. Meanwhile, forward chaining is biased toward
+ * the sources that unify with the leaves of the BIT, and the rules
+ * which conclusions unify with them.
+ *
+ * Both chainers are configured by the same rule-base, and run till
+ * both have terminated, or the backward chainer has answered the
+ * target (see URE:BC:confidence-threshold).
+ */
+class BidirectionalChainer
+{
+public:
+	/**
+	 * CTor, see ForwardChainer and BackwardChainer for the
+	 * description of the arguments. The bias is the factor applied
+	 * to the weights of the sources and rules unifying with the
+	 * leaves of the BIT.
+	 */
+	BidirectionalChainer(AtomSpace& kb_as,
+	                     AtomSpace& rb_as,
+	                     const Handle& rbs,
+	                     const Handle& source,
+	                     const Handle& target,
+	                     const Handle& source_vardecl=Handle::UNDEFINED,
+	                     const Handle& target_vardecl=Handle::UNDEFINED,
+	                     double bias=10.0);
+
+	ForwardChainer& get_forward_chainer();
+	BackwardChainer& get_backward_chainer();
+
+	/**
+	 * Alternate forward and backward chaining steps till termination.
+	 */
+	void do_chain();
+
+	/**
+	 * Perform a backward chaining step followed by a forward chaining
+	 * step, then fulfill the and-BITs met by the new products.
+	 *
+	 * When stepping manually, both chainers must be prepared and
+	 * wrapped up as well, see ForwardChainer::begin_chain and
+	 * BackwardChainer::begin_chain.
+	 */
+	void do_step();
+
+	/**
+	 * @return true if both chainers have terminated, or the target
+	 * has been answered.
+	 */
+	bool termination();
+
+	/**
+	 * Return the results of the backward chainer, thus matching the
+	 * target.
+	 */
+	Handle get_results() const;
+	const HandleSet& get_results_set() const;
+
+	/**
+	 * Return the number of and-BITs fulfilled so far because some of
+	 * their leaves have been met by forward chaining products.
+	 */
+	size_t get_met_fulfillment_count() const;
+
+private:
+	// Unify the new products of the forward chainer with the leaves
+	// of the BIT and fulfill the and-BITs containing matching leaves.
+	void meet();
+
+	// Update _leaves if the BIT has changed, and unify the new leaves
+	// with the products met so far. The leaves still in the BIT keep
+	// their order, the new ones are appended, so that the memoized
+	// unifications remain valid, unless some leaves have been
+	// removed.
+	void update_leaves();
+
+	// Fulfill the and-BITs containing the met leaves
+	void fulfill(const HandleSet& met_leaves);
+
+	// Return true if the term, with its variable declaration, unifies
+	// with at least one leaf of the BIT. Memoized, only the leaves
+	// added since the last call are unified with the term.
+	bool unifies_with_leaves(const Handle& term, const Handle& vardecl);
+
+	// Return the subset of leaves, from index begin on, unifying with
+	// the term
+	HandleSet unified_leaves(const Handle& term, const Handle& vardecl,
+	                         const HandlePairSeq& leaves,
+	                         size_t begin=0) const;
+
+	// Return false if the term and the leaf cannot possibly unify
+	// because their root types differ. Used to avoid most
+	// unifications.
+	static bool may_unify(const Handle& term, const Handle& leaf);
+
+	ForwardChainer _fc;
+	BackwardChainer _bc;
+
+	double _bias;
+
+	// Leaves of the BIT, with their variable declarations
+	HandlePairSeq _leaves;
+
+	// Memoized results of unifies_with_leaves, alongside the number
+	// of leaves of _leaves they account for. Only cleared if some
+	// leaves are removed from the BIT.
+	std::unordered_map<Handle, std::pair<bool, size_t>> _unifications;
+
+	// Products of the forward chainer already unified with the
+	// leaves, by root type
+	std::map<Type, HandleSeq> _met_products;
+
+	// Number of and-BITs fulfilled because met by products
+	size_t _met_fulfillment_count;
+
+	// Number of results of the forward chainer already met, see
+	// ForwardChainer::get_new_results
+	size_t _fc_results_cursor;
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_BIDIRECTIONALCHAINER_H_
@@ -0,0 +1,156 @@
+/*
+ * ChainerStats.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <sstream>
+
+#include "ChainerStats.h"
+
+namespace opencog {
+
+ChainerStats::Timer::Timer(ChainerStats& stats, Phase phase)
+	: _stats(stats.is_enabled() ? &stats : nullptr), _phase(phase)
+{
+	if (_stats)
+		_start = std::chrono::steady_clock::now();
+}
+
+ChainerStats::Timer::~Timer()
+{
+	if (_stats)
+		_stats->record(_phase, std::chrono::duration<double>(
+			               std::chrono::steady_clock::now() - _start).count());
+}
+
+ChainerStats::ChainerStats() : _enabled(false)
+{
+	reset();
+}
+
+void ChainerStats::set_enabled(bool enabled)
+{
+	_enabled = enabled;
+}
+
+bool ChainerStats::is_enabled() const
+{
+	return _enabled.load(std::memory_order_relaxed);
+}
+
+void ChainerStats::record(Phase phase, double seconds)
+{
+	PhaseCounters& pc = _phases[phase];
+	uint64_t ns = seconds * 1e9;
+	pc.count++;
+	pc.total_nanoseconds += ns;
+
+	// Bin index is the number of bits of the latency in microseconds
+	size_t bin = 0;
+	for (uint64_t us = ns / 1000; us and bin < bin_count - 1; us >>= 1)
+		bin++;
+	pc.histogram[bin]++;
+}
+
+void ChainerStats::record_population(int iteration, size_t size)
+{
+	if (not is_enabled())
+		return;
+	std::lock_guard<std::mutex> lock(_populations_mutex);
+	_populations.emplace_back(iteration, size);
+}
+
+void ChainerStats::reset()
+{
+	for (PhaseCounters& pc : _phases) {
+		pc.count = 0;
+		pc.total_nanoseconds = 0;
+		for (std::atomic<uint64_t>& b : pc.histogram)
+			b = 0;
+	}
+	std::lock_guard<std::mutex> lock(_populations_mutex);
+	_populations.clear();
+}
+
+ChainerStats::PhaseStats ChainerStats::get_phase_stats(Phase phase) const
+{
+	const PhaseCounters& pc = _phases[phase];
+	PhaseStats ps;
+	ps.count = pc.count;
+	ps.total_seconds = pc.total_nanoseconds * 1e-9;
+	for (size_t i = 0; i < bin_count; i++)
+		ps.histogram[i] = pc.histogram[i];
+	return ps;
+}
+
+ChainerStats::Populations ChainerStats::get_populations() const
+{
+	std::lock_guard<std::mutex> lock(_populations_mutex);
+	return _populations;
+}
+
+const char* ChainerStats::phase_name(Phase phase)
+{
+	static const char* names[PHASE_COUNT] = {
+		"meta_rule_expansion",
+		"source_selection",
+		"unification",
+		"pool_population",
+		"thompson_selection",
+		"rule_application",
+		"source_insertion",
+		"bc_expansion",
+		"fulfillment",
+		"reduction"
+	};
+	return names[phase];
+}
+
+std::string ChainerStats::to_json() const
+{
+	std::stringstream ss;
+	ss << "{\"phases\": {";
+	bool first = true;
+	for (int p = 0; p < PHASE_COUNT; p++) {
+		PhaseStats ps = get_phase_stats((Phase)p);
+		if (ps.count == 0)
+			continue;
+		size_t last = bin_count;
+		while (0 < last and ps.histogram[last - 1] == 0)
+			last--;
+		ss << (first ? "" : ", ")
+		   << "\"" << phase_name((Phase)p) << "\": {"
+		   << "\"count\": " << ps.count
+		   << ", \"total_seconds\": " << ps.total_seconds
+		   << ", \"histogram\": [";
+		for (size_t i = 0; i < last; i++)
+			ss << (i ? ", " : "") << ps.histogram[i];
+		ss << "]}";
+		first = false;
+	}
+	ss << "}, \"populations\": [";
+	Populations pops = get_populations();
+	for (size_t i = 0; i < pops.size(); i++)
+		ss << (i ? ", " : "") << "[" << pops[i].first
+		   << ", " << pops[i].second << "]";
+	ss << "]}";
+	return ss.str();
+}
+
+} // ~namespace opencog
@@ -0,0 +1,154 @@
+/*
+ * ChainerStats.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_CHAINER_STATS_H_
+#define _OPENCOG_CHAINER_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace opencog
+{
+
+/**
+ * Profiling counters of a chainer. For each phase of chaining, the
+ * number of times it was run and a histogram of its latencies are
+ * recorded. The size of the population (sources for the forward
+ * chainer, and-BITs for the backward chainer) is recorded at each
+ * iteration as well.
+ *
+ * Recording is disabled by default, see URE:collect-stats, in which
+ * case timing a phase merely costs a test of a flag.
+ *
+ * Latencies are inclusive, if a phase is run within another one (for
+ * instance unification within pool population) it is counted in
+ * both. Recording is thread safe.
+ */
+class ChainerStats
+{
+public:
+	enum Phase {
+		META_RULE_EXPANSION,
+		SOURCE_SELECTION,
+		UNIFICATION,
+		POOL_POPULATION,
+		THOMPSON_SELECTION,
+		RULE_APPLICATION,
+		SOURCE_INSERTION,
+		BC_EXPANSION,
+		FULFILLMENT,
+		REDUCTION,
+		PHASE_COUNT
+	};
+
+	// Latency histograms have logarithmic bins, bin 0 counts latencies
+	// under 1 microsecond, bin i latencies in [2^(i-1), 2^i)
+	// microseconds, and the last bin all the greater ones.
+	static const size_t bin_count = 32;
+	typedef std::array<uint64_t, bin_count> Histogram;
+
+	// Snapshot of the counters of a phase
+	struct PhaseStats
+	{
+		uint64_t count = 0;
+		double total_seconds = 0.0;
+		Histogram histogram = {};
+	};
+
+	// Population size per iteration
+	typedef std::vector<std::pair<int, size_t>> Populations;
+
+	/**
+	 * Time a phase, from construction to destruction, if recording is
+	 * enabled.
+	 */
+	class Timer
+	{
+	public:
+		Timer(ChainerStats& stats, Phase phase);
+		~Timer();
+
+	private:
+		ChainerStats* _stats;
+		Phase _phase;
+		std::chrono::steady_clock::time_point _start;
+	};
+
+	ChainerStats();
+
+	void set_enabled(bool enabled);
+	bool is_enabled() const;
+
+	/**
+	 * Record a run of phase that lasted the given number of seconds.
+	 */
+	void record(Phase phase, double seconds);
+
+	/**
+	 * Record the population size at the given iteration.
+	 */
+	void record_population(int iteration, size_t size);
+
+	/**
+	 * Clear all counters, not the enabled flag.
+	 */
+	void reset();
+
+	PhaseStats get_phase_stats(Phase phase) const;
+	Populations get_populations() const;
+
+	static const char* phase_name(Phase phase);
+
+	/**
+	 * Return the counters as a JSON object, such as
+	 *
+	 * {"phases": {"unification": {"count": 12, "total_seconds": 0.0031,
+	 *                             "histogram": [0, 0, 3, 9]}, ...},
+	 *  "populations": [[1, 1], [2, 3], ...]}
+	 *
+	 * Phases that were never run are omitted, as well as the trailing
+	 * empty bins of the histograms.
+	 */
+	std::string to_json() const;
+
+private:
+	struct PhaseCounters
+	{
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> total_nanoseconds;
+		std::array<std::atomic<uint64_t>, bin_count> histogram;
+	};
+
+	std::atomic<bool> _enabled;
+	std::array<PhaseCounters, PHASE_COUNT> _phases;
+
+	mutable std::mutex _populations_mutex;
+	Populations _populations;
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_CHAINER_STATS_H_
@@ -0,0 +1,195 @@
+/*
+ * ClausePlanner.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <numeric>
+
+#include <boost/range/algorithm/stable_sort.hpp>
+#include <boost/range/algorithm/find.hpp>
+
+#include <opencog/atoms/core/FindUtils.h>
+
+#include "ClausePlanner.h"
+
+using namespace opencog;
+
+const size_t ClausePlan::unknown = std::numeric_limits<size_t>::max();
+
+bool ClausePlan::unsatisfiable() const
+{
+	return boost::find(estimates, 0) != estimates.end();
+}
+
+ClausePlan ClausePlanner::operator()(const Handle& pattern,
+                                     const HandleSeq& clauses,
+                                     const HandleSet& varset,
+                                     AtomSpace& as)
+{
+	ClauseInfos infos = get_infos(pattern, clauses, varset);
+
+	// Calculate the estimates, stop at the first unsatisfiable clause
+	std::vector<size_t> estimates;
+	for (const ClauseInfo& ci : infos) {
+		estimates.push_back(estimate(ci, as));
+		if (estimates.back() == 0)
+			break;
+	}
+	estimates.resize(infos.size(), ClausePlan::unknown);
+
+	// Order the clauses by increasing estimates
+	std::vector<size_t> order(infos.size());
+	std::iota(order.begin(), order.end(), 0);
+	boost::stable_sort(order, [&](size_t l, size_t r) {
+			return estimates[l] < estimates[r]; });
+
+	ClausePlan plan;
+	for (size_t i : order) {
+		plan.clauses.push_back(infos[i].clause);
+		plan.estimates.push_back(estimates[i]);
+	}
+	return plan;
+}
+
+ClausePlanner::ClausePlanner(size_t max_size)
+	: _max_size(max_size), _size(0) {}
+
+size_t ClausePlanner::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _size;
+}
+
+ClausePlanner::ClauseInfo ClausePlanner::analyze(const Handle& clause,
+                                                 const HandleSet& varset)
+{
+	ClauseInfo ci;
+	ci.clause = clause;
+	ci.constant = is_constant(varset, clause);
+	ci.estimable = is_estimable(clause);
+	if (ci.estimable and not ci.constant)
+		collect_anchors(clause, varset, ci.anchors);
+	return ci;
+}
+
+void ClausePlanner::collect_anchors(const Handle& h, const HandleSet& varset,
+                                    std::vector<Anchor>& anchors)
+{
+	for (const Handle& child : h->getOutgoingSet()) {
+		if (is_constant(varset, child)) {
+			// Undeclared variables may match anything, ignore them
+			if (not contains_atomtype(child, VARIABLE_NODE))
+				anchors.emplace_back(child, h->get_type());
+		} else if (child->is_link()) {
+			collect_anchors(child, varset, anchors);
+		}
+	}
+}
+
+// Return true if h or any of its descendants inherits from one of
+// the given types, regardless of quotations.
+static bool contains_any_type(const Handle& h, const std::vector<Type>& types)
+{
+	for (Type t : types)
+		if (nameserver().isA(h->get_type(), t))
+			return true;
+	if (h->is_link())
+		for (const Handle& child : h->getOutgoingSet())
+			if (contains_any_type(child, types))
+				return true;
+	return false;
+}
+
+bool ClausePlanner::is_estimable(const Handle& clause)
+{
+	// A bare variable clause, such as the premises of (Present $X1
+	// $X2), may be grounded by atoms of any type, its type is not the
+	// type of its groundings.
+	if (nameserver().isA(clause->get_type(), VARIABLE_NODE))
+		return false;
+
+	// Clauses evaluated, rather than matched, by the pattern matcher
+	static const std::vector<Type> evaluated_types{
+		VIRTUAL_LINK, AND_LINK, OR_LINK, NOT_LINK, PRESENT_LINK,
+		ABSENT_LINK, ALWAYS_LINK, CHOICE_LINK,
+		SEQUENTIAL_AND_LINK, SEQUENTIAL_OR_LINK};
+	for (Type t : evaluated_types)
+		if (nameserver().isA(clause->get_type(), t))
+			return false;
+
+	// Clauses that are not matched syntactically, either because they
+	// are executed, quoted, or matched up to alpha-conversion
+	static const std::vector<Type> special_types{
+		GROUNDED_PREDICATE_NODE, GROUNDED_SCHEMA_NODE,
+		DEFINED_PREDICATE_NODE, DEFINED_SCHEMA_NODE,
+		GLOB_NODE, QUOTE_LINK, UNQUOTE_LINK, LOCAL_QUOTE_LINK,
+		DONT_EXEC_LINK, EXECUTION_OUTPUT_LINK, SCOPE_LINK};
+	return not contains_any_type(clause, special_types);
+}
+
+size_t ClausePlanner::estimate(const ClauseInfo& ci, AtomSpace& as)
+{
+	// Clauses that are evaluated, such as grounded predicates or
+	// virtual links, need not be in the atomspace to be satisfied,
+	// even if constant.
+	if (not ci.estimable)
+		return ClausePlan::unknown;
+	if (ci.constant)
+		return as.get_atom(ci.clause) ? 1 : 0;
+
+	// A grounding is an atom of the clause type, which, for each
+	// anchor, contains that anchor under a parent of the anchor
+	// parent type.
+	size_t est = as.get_num_atoms_of_type(ci.clause->get_type());
+	for (const Anchor& anchor : ci.anchors) {
+		if (est == 0)
+			break;
+		Handle h = as.get_atom(anchor.first);
+		if (not h)
+			return 0;
+		est = std::min(est, h->getIncomingSetSizeByType(anchor.second));
+	}
+	return est;
+}
+
+ClausePlanner::ClauseInfos ClausePlanner::get_infos(const Handle& pattern,
+                                                    const HandleSeq& clauses,
+                                                    const HandleSet& varset)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _cache.find(pattern->get_hash());
+	if (it != _cache.end())
+		for (const auto& pi : it->second)
+			if (pi.first == pattern or content_eq(pi.first, pattern))
+				return pi.second;
+
+	ClauseInfos infos;
+	for (const Handle& clause : clauses)
+		infos.push_back(analyze(clause, varset));
+
+	// Start over when full, the analysis being cheap compared to
+	// keeping the patterns of every FCS alive
+	if (_max_size <= _size) {
+		_cache.clear();
+		_size = 0;
+	}
+	_cache[pattern->get_hash()].emplace_back(pattern, infos);
+	_size++;
+	return infos;
+}
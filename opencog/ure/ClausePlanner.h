@@ -0,0 +1,146 @@
+/*
+ * ClausePlanner.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_CLAUSEPLANNER_H_
+#define _OPENCOG_CLAUSEPLANNER_H_
+
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+namespace opencog
+{
+
+/**
+ * Plan describing how selective the clauses of a pattern are over a
+ * given atomspace, the most selective clauses coming first.
+ */
+struct ClausePlan
+{
+	// Value of an estimate for clauses that cannot be estimated,
+	// such as virtual or evaluatable clauses.
+	static const size_t unknown;
+
+	// Clauses ordered by increasing estimates
+	HandleSeq clauses;
+
+	// Upper bound of the number of groundings of each clause
+	std::vector<size_t> estimates;
+
+	/**
+	 * Return true if at least one clause is known to have no
+	 * grounding, in which case the pattern cannot be satisfied.
+	 */
+	bool unsatisfiable() const;
+};
+
+/**
+ * Order the clauses of patterns (FCS or rule) by selectivity, based
+ * on cheap atomspace statistics, the number of atoms of the clause
+ * type and the incoming set sizes of the constant atoms of the
+ * clause. Since these constants are typically the ones introduced by
+ * unification with the source (FC) or the target (BC), clauses bound
+ * to them come first.
+ *
+ * The structural analysis of a pattern (its clauses and their
+ * constants) is cached per pattern content hash, the estimates are
+ * recalculated at each call to reflect the current state of the
+ * atomspace. The cache is emptied once it holds max_size patterns.
+ *
+ * Note that the pattern matcher does not follow the order of the
+ * clauses of an AndLink, which is unordered anyway. The plan is thus
+ * used to discard, the most selective clause first, patterns that
+ * cannot be satisfied before calling the pattern matcher.
+ */
+class ClausePlanner
+{
+public:
+	ClausePlanner(size_t max_size = 4096);
+
+	/**
+	 * Return the plan of the given clauses, over the given
+	 * variables, with estimates calculated over as. The pattern is
+	 * only used as cache key and can be any atom, such as an FCS or a
+	 * rule, that determines the clauses and the variables.
+	 *
+	 * Thread safe.
+	 */
+	ClausePlan operator()(const Handle& pattern, const HandleSeq& clauses,
+	                      const HandleSet& varset, AtomSpace& as);
+
+	/**
+	 * Return the number of cached patterns.
+	 */
+	size_t size() const;
+
+private:
+	// A constant atom of a clause, alongside the type of its parent,
+	// which has to be in the incoming set of that atom in the
+	// atomspace for the clause to have groundings.
+	typedef std::pair<Handle, Type> Anchor;
+
+	struct ClauseInfo
+	{
+		Handle clause;
+
+		// Whether the clause contains no variable
+		bool constant;
+
+		// Whether the clause can be estimated at all
+		bool estimable;
+
+		// Maximal constant sub-atoms of the clause
+		std::vector<Anchor> anchors;
+	};
+	typedef std::vector<ClauseInfo> ClauseInfos;
+
+	// Analyze the structure of a clause
+	static ClauseInfo analyze(const Handle& clause, const HandleSet& varset);
+	static void collect_anchors(const Handle& h, const HandleSet& varset,
+	                            std::vector<Anchor>& anchors);
+	static bool is_estimable(const Handle& clause);
+
+	// Return an upper bound of the number of groundings of a clause
+	// over as.
+	static size_t estimate(const ClauseInfo& ci, AtomSpace& as);
+
+	// Return the cached clause infos of the given pattern, analyzing
+	// the clauses if not in the cache.
+	ClauseInfos get_infos(const Handle& pattern, const HandleSeq& clauses,
+	                      const HandleSet& varset);
+
+	// Map pattern content hash to its patterns and clause infos.
+	// Patterns are stored to handle hash collisions.
+	typedef std::vector<std::pair<Handle, ClauseInfos>> CacheBucket;
+	std::unordered_map<ContentHash, CacheBucket> _cache;
+
+	// Maximum and current number of cached patterns
+	size_t _max_size;
+	size_t _size;
+
+	mutable std::mutex _mutex;
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_CLAUSEPLANNER_H_
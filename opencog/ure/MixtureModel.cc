@@ -35,12 +35,18 @@
 
 using namespace opencog;
 
-MixtureModel::MixtureModel(const HandleSet& mds, double cpx, double cmp) :
-	models(mds), cpx_penalty(cpx), compressiveness(cmp)
+MixtureModel::MixtureModel(const HandleSet& mds, double cpx, double cmp,
+                           const ModelStatsMap* mss) :
+	models(mds), cpx_penalty(cpx), compressiveness(cmp), _model_stats(mss)
 {
 	data_set_size = infer_data_set_size();
 }
 
+MixtureModel::ModelStats MixtureModel::get_model_stats(const Handle& model)
+{
+	return {calculate_length(model), calculate_beta_factor(model)};
+}
+
 TruthValuePtr MixtureModel::operator()() const
 {
 	// Don't bother mixing if there's only one TV
@@ -95,8 +101,8 @@ TruthValuePtr MixtureModel::weighted_average(const std::vector<TruthValuePtr>& t
 
 double MixtureModel::beta_factor(const Handle& model) const
 {
-	BetaDistribution beta_dist(model->getTruthValue());
-	double factor = boost::math::beta(beta_dist.alpha(), beta_dist.beta());
+	const ModelStats* ms = find_model_stats(model);
+	double factor = ms ? ms->beta_factor : calculate_beta_factor(model);
 	LAZY_URE_LOG_FINE << "MixtureModel::beta_factor factor = " << factor;
 	return factor;
 }
@@ -105,8 +111,8 @@ double MixtureModel::prior_estimate(const Handle& model) const
 {
 	LAZY_URE_LOG_FINE << "MixtureModel::prior_estimate model = " << model->id_to_string();
 
-	HandleSet all_atoms(get_all_uniq_atoms(model));
-	double partial_length = all_atoms.size(),
+	const ModelStats* ms = find_model_stats(model);
+	double partial_length = ms ? ms->length : calculate_length(model),
 		remain_data_size = data_set_size - model->getTruthValue()->get_count(),
 		kestimate = kolmogorov_estimate(remain_data_size);
 
@@ -131,6 +137,25 @@ double MixtureModel::prior(double length) const
 	return pri;
 }
 
+const MixtureModel::ModelStats* MixtureModel::find_model_stats(const Handle& model) const
+{
+	if (not _model_stats)
+		return nullptr;
+	auto it = _model_stats->find(model);
+	return it == _model_stats->end() ? nullptr : &it->second;
+}
+
+double MixtureModel::calculate_beta_factor(const Handle& model)
+{
+	BetaDistribution beta_dist(model->getTruthValue());
+	return boost::math::beta(beta_dist.alpha(), beta_dist.beta());
+}
+
+double MixtureModel::calculate_length(const Handle& model)
+{
+	return get_all_uniq_atoms(model).size();
+}
+
 double MixtureModel::infer_data_set_size() const
 {
 	double max_count = 0.0;
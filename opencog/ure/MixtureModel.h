@@ -23,6 +23,8 @@
 #ifndef _OPENCOG_MIXTUREMODEL_H_
 #define _OPENCOG_MIXTUREMODEL_H_
 
+#include <unordered_map>
+
 #include <opencog/atoms/base/Handle.h>
 #include <opencog/atoms/truthvalue/TruthValue.h>
 
@@ -39,6 +41,18 @@ namespace opencog
 class MixtureModel
 {
 public:
+	// Statistics of a model that only depend on the model itself, and
+	// can thus be precomputed once for all mixtures involving it.
+	struct ModelStats
+	{
+		// Number of unique atoms of the model
+		double length;
+
+		// Beta(alpha, beta) of the model's TV
+		double beta_factor;
+	};
+	typedef std::unordered_map<Handle, ModelStats> ModelStatsMap;
+
 	// Set of active models. Active means that they fulfill the
 	// preconditions of the data to explain.
 	HandleSet models;
@@ -68,7 +82,13 @@ public:
 	 */
 	MixtureModel(const HandleSet& models,
 	             double cpx_penalty=1.0,
-	             double compressiveness=0.0);
+	             double compressiveness=0.0,
+	             const ModelStatsMap* model_stats=nullptr);
+
+	/**
+	 * Calculate the statistics of a model, see ModelStats.
+	 */
+	static ModelStats get_model_stats(const Handle& model);
 
 	/**
 	 * Calculate the TV of the mixture model. Assuming the ith model,
@@ -121,6 +141,8 @@ public:
 	/**
 	 * Calculate the alpha and beta parameters of the model's TV, and
 	 * return Beta(alpha, beta), where Beta is the beta function.
+	 *
+	 * Use the precomputed model statistics if available.
 	 */
 	double beta_factor(const Handle& model) const;
 
@@ -160,6 +182,16 @@ public:
 	double prior(double length) const;
 
 private:
+	// Precomputed model statistics, if any
+	const ModelStatsMap* _model_stats;
+
+	// Return the precomputed statistics of a model, or nullptr if
+	// not available.
+	const ModelStats* find_model_stats(const Handle& model) const;
+
+	static double calculate_beta_factor(const Handle& model);
+	static double calculate_length(const Handle& model);
+
 	/**
 	 * Infer the data set size by taking the max count of all models
 	 * (it works assuming that one of them is complete).
@@ -43,6 +43,7 @@
 #include <opencog/unify/Unify.h>
 
 #include "URELogger.h"
+#include "Utils.h"
 
 #include "Rule.h"
 
@@ -71,7 +72,7 @@ void RuleSet::expand_meta_rules(AtomSpace& as)
 				createRule(rule->get_alias(), produced_h, rule->get_rbs());
 			auto [_, ir] = insert(produced);
 			if (ir) {
-				ure_logger().debug() << "New rule instantiated from a meta rule:"
+				LAZY_URE_LOG_DEBUG << "New rule instantiated from a meta rule:"
 											<< std::endl << oc_to_string(*produced);
 			}
 		}
@@ -640,8 +641,9 @@ Rule Rule::rand_alpha_converted() const
 	// Clone the rule
 	Rule result(*this);
 
-	// Alpha convert the rule
-	result.set_rule(_rule->alpha_convert());
+	// Alpha convert the rule, with names drawn from the chainer
+	// generator, the global one being shared by all threads
+	result.set_rule(opencog::rand_alpha_converted(Handle(_rule)));
 
 	return result;
 }
@@ -0,0 +1,188 @@
+/*
+ * RuleDependencyGraph.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <opencog/unify/Unify.h>
+#include <opencog/atoms/core/FindUtils.h>
+
+#include "RuleDependencyGraph.h"
+#include "URELogger.h"
+
+using namespace opencog;
+
+RuleDependencyGraph::RuleDependencyGraph(const RuleSet& rules)
+	: _rules(rules),
+	  _producers(rules.size()),
+	  _predecessors(rules.size())
+{
+	// Alpha convert the producers so that their variables do not
+	// collide with the ones of the consumers.
+	std::vector<Rule> alpha_rules;
+	for (const RulePtr& rule : _rules)
+		alpha_rules.push_back(rule->rand_alpha_converted());
+
+	for (size_t i = 0; i < _rules.size(); i++) {
+		const Rule& consumer = *_rules[i];
+		if (consumer.is_meta())
+			continue;
+		HandleSeq premises = consumer.get_premises();
+		_producers[i].resize(premises.size());
+		for (size_t k = 0; k < premises.size(); k++) {
+			for (size_t j = 0; j < _rules.size(); j++) {
+				const Rule& producer = alpha_rules[j];
+				if (producer.is_meta())
+					continue;
+				if (unifies(producer.get_conclusion(), producer.get_vardecl(),
+				            premises[k], consumer.get_vardecl())) {
+					_producers[i][k].push_back(j);
+					_predecessors[i].insert(j);
+				}
+			}
+		}
+	}
+}
+
+const RuleSet& RuleDependencyGraph::get_rules() const
+{
+	return _rules;
+}
+
+bool RuleDependencyGraph::is_reachable(const RulePtr& from,
+                                       const RulePtr& to) const
+{
+	size_t from_i = index(from), to_i = index(to);
+	if (from_i == _rules.size() or to_i == _rules.size())
+		return false;
+	std::set<size_t> from_to = ancestors({to_i});
+	return from_to.find(from_i) != from_to.end();
+}
+
+RuleSet RuleDependencyGraph::relevant_rules(const Handle& goal,
+                                            const Handle& vardecl) const
+{
+	std::vector<size_t> concluding;
+	for (size_t i = 0; i < _rules.size(); i++) {
+		if (_rules[i]->is_meta())
+			continue;
+		Rule alpha_rule = _rules[i]->rand_alpha_converted();
+		if (unifies(alpha_rule.get_conclusion(), alpha_rule.get_vardecl(),
+		            goal, vardecl))
+			concluding.push_back(i);
+	}
+	return mk_rule_set(ancestors(concluding));
+}
+
+RuleSet RuleDependencyGraph::grounded_rules(const AtomSpace& kb) const
+{
+	// Premises that may be found in the knowledge-base
+	std::vector<std::vector<bool>> in_kb(_rules.size());
+	for (size_t i = 0; i < _rules.size(); i++)
+		for (const Handle& premise : _rules[i]->get_premises())
+			in_kb[i].push_back(may_be_in_kb(premise, kb));
+
+	// Propagate groundedness till fixed point
+	std::vector<bool> grounded(_rules.size(), false);
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (size_t i = 0; i < _rules.size(); i++) {
+			if (grounded[i] or _rules[i]->is_meta())
+				continue;
+			bool all_premises = true;
+			for (size_t k = 0; k < _producers[i].size() and all_premises; k++) {
+				if (in_kb[i][k])
+					continue;
+				all_premises = false;
+				for (size_t j : _producers[i][k])
+					if (grounded[j])
+						all_premises = true;
+			}
+			if (all_premises) {
+				grounded[i] = true;
+				changed = true;
+			}
+		}
+	}
+
+	std::set<size_t> indices;
+	for (size_t i = 0; i < _rules.size(); i++)
+		if (grounded[i])
+			indices.insert(i);
+	return mk_rule_set(indices);
+}
+
+size_t RuleDependencyGraph::index(const RulePtr& rule) const
+{
+	for (size_t i = 0; i < _rules.size(); i++)
+		if (*_rules[i] == *rule)
+			return i;
+	return _rules.size();
+}
+
+std::set<size_t> RuleDependencyGraph::ancestors(const std::vector<size_t>& rules) const
+{
+	std::set<size_t> visited(rules.begin(), rules.end());
+	std::vector<size_t> stack(rules);
+	while (not stack.empty()) {
+		size_t i = stack.back();
+		stack.pop_back();
+		for (size_t j : _predecessors[i])
+			if (visited.insert(j).second)
+				stack.push_back(j);
+	}
+	return visited;
+}
+
+RuleSet RuleDependencyGraph::mk_rule_set(const std::set<size_t>& indices) const
+{
+	RuleSet rules;
+	for (size_t i = 0; i < _rules.size(); i++) {
+		if (_rules[i]->is_meta() or indices.find(i) != indices.end())
+			rules.push_back(_rules[i]);
+		else
+			LAZY_URE_LOG_DEBUG << "Discard rule " << _rules[i]->get_name();
+	}
+	return rules;
+}
+
+bool RuleDependencyGraph::unifies(const Handle& lhs, const Handle& lhs_vardecl,
+                                  const Handle& rhs, const Handle& rhs_vardecl)
+{
+	Unify unify(lhs, rhs, lhs_vardecl, rhs_vardecl);
+	return unify().is_satisfiable();
+}
+
+bool RuleDependencyGraph::may_be_in_kb(const Handle& premise,
+                                       const AtomSpace& kb)
+{
+	Type type = premise->get_type();
+	if (type == VARIABLE_NODE or type == GLOB_NODE or type == UNQUOTE_LINK)
+		return true;
+
+	// Look through the quotation, the premise matches the quoted atom
+	if ((type == QUOTE_LINK or type == LOCAL_QUOTE_LINK)
+	    and premise->get_arity() == 1)
+		return may_be_in_kb(premise->getOutgoingAtom(0), kb);
+
+	if (nameserver().isA(type, EVALUATABLE_LINK) and
+	    (contains_atomtype(premise, GROUNDED_PREDICATE_NODE) or
+	     contains_atomtype(premise, DEFINED_PREDICATE_NODE)))
+		return true;
+	return 0 < kb.get_num_atoms_of_type(type);
+}
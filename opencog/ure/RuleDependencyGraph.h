@@ -0,0 +1,108 @@
+/*
+ * RuleDependencyGraph.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_RULEDEPENDENCYGRAPH_H_
+#define _OPENCOG_RULEDEPENDENCYGRAPH_H_
+
+#include <set>
+#include <vector>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "Rule.h"
+
+namespace opencog
+{
+
+/**
+ * Static dependency graph of a rule set. There is an edge from rule
+ * r1 to rule r2 if the conclusion of r1 unifies with some premise of
+ * r2, meaning that r1 may produce a premise of r2.
+ *
+ * The graph is built once, with as many unifications as pairs of
+ * conclusions and premises, and then allows to cheaply discard rules
+ * that cannot contribute to a goal, or cannot be grounded in a
+ * knowledge-base.
+ *
+ * Meta rules, producing rules rather than conclusions, are never
+ * discarded, as the rules they produce are not in the graph.
+ */
+class RuleDependencyGraph
+{
+public:
+	RuleDependencyGraph(const RuleSet& rules);
+
+	const RuleSet& get_rules() const;
+
+	/**
+	 * Return true iff there is a path from rule from to rule to,
+	 * that is from may, directly or indirectly, produce a premise of
+	 * to. Rules not in the graph are never reachable.
+	 */
+	bool is_reachable(const RulePtr& from, const RulePtr& to) const;
+
+	/**
+	 * Return the rules that may contribute to produce the goal, that
+	 * is the rules which conclusion unifies with the goal, and the
+	 * rules with a path to them. The order of the rule set is
+	 * preserved.
+	 */
+	RuleSet relevant_rules(const Handle& goal,
+	                       const Handle& vardecl=Handle::UNDEFINED) const;
+
+	/**
+	 * Return the rules with a path back to the knowledge-base, that
+	 * is the rules which premises may all be found in kb, or produced
+	 * by such rules. A premise may be found in kb if it is a
+	 * variable, is evaluatable, or if kb has atoms of its type,
+	 * quotations aside. The order of the rule set is preserved.
+	 */
+	RuleSet grounded_rules(const AtomSpace& kb) const;
+
+private:
+	// Return the index of the rule, or the number of rules if absent
+	size_t index(const RulePtr& rule) const;
+
+	// Return the indices of the rules reachable backward, following
+	// the edges in reverse, from the given rule indices, included.
+	std::set<size_t> ancestors(const std::vector<size_t>& rules) const;
+
+	// Build the rule set of the given indices, plus the meta rules
+	RuleSet mk_rule_set(const std::set<size_t>& indices) const;
+
+	static bool unifies(const Handle& lhs, const Handle& lhs_vardecl,
+	                    const Handle& rhs, const Handle& rhs_vardecl);
+
+	static bool may_be_in_kb(const Handle& premise, const AtomSpace& kb);
+
+	RuleSet _rules;
+
+	// _producers[i][k] holds the indices of the rules which
+	// conclusions unify with premise k of rule i.
+	std::vector<std::vector<std::vector<size_t>>> _producers;
+
+	// _predecessors[i] holds the indices of the rules with an edge to
+	// rule i, that is the union of _producers[i][k] over k.
+	std::vector<std::set<size_t>> _predecessors;
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_RULEDEPENDENCYGRAPH_H_
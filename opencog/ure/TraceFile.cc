@@ -0,0 +1,262 @@
+/*
+ * TraceFile.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/atoms/base/Atom.h>
+#include <opencog/atoms/truthvalue/TruthValue.h>
+
+#include "TraceFile.h"
+
+using namespace opencog;
+
+const char TraceFile::magic[8] = {'U', 'R', 'E', 'T', 'R', 'A', 'C', 'E'};
+const uint32_t TraceFile::version = 2;
+
+// Size beyond which the buffered records are written to the file
+static const size_t flush_threshold = 1 << 20;
+
+TraceFile::TraceFile(const std::string& filename, unsigned sampling)
+	: _filename(filename),
+	  _file(filename, std::ios::binary | std::ios::app),
+	  _sampling(std::max(1U, sampling)),
+	  _submitted(0),
+	  _last_run(0)
+{
+	// Draw the session identifier, mixing in the clock in case
+	// random_device is deterministic on that platform
+	std::random_device rd;
+	_session = rd() ^ (uint32_t)std::chrono::system_clock::now()
+		.time_since_epoch().count();
+
+	if (not _file)
+		throw RuntimeException(TRACE_INFO, "Cannot open trace file %s",
+		                       filename.c_str());
+
+	_file.seekp(0, std::ios::end);
+	if (_file.tellp() == 0) {
+		_file.write(magic, sizeof(magic));
+		_file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+		return;
+	}
+
+	// Do not append to a file of another format
+	std::ifstream in(filename, std::ios::binary);
+	char file_magic[sizeof(magic)];
+	uint32_t file_version = 0;
+	in.read(file_magic, sizeof(file_magic));
+	in.read(reinterpret_cast<char*>(&file_version), sizeof(file_version));
+	if (not in or std::memcmp(file_magic, magic, sizeof(magic)) != 0
+	    or file_version != version)
+		throw RuntimeException(TRACE_INFO, "%s is not a URE trace file "
+		                       "of version %u", filename.c_str(), version);
+}
+
+TraceFile::~TraceFile()
+{
+	flush();
+}
+
+const std::string& TraceFile::get_filename() const
+{
+	return _filename;
+}
+
+void TraceFile::set_sampling(unsigned sampling)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_sampling = std::max(1U, sampling);
+}
+
+unsigned TraceFile::get_sampling() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _sampling;
+}
+
+uint64_t TraceFile::run(RunKind kind)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	uint64_t run = ((uint64_t)_session << 32) | ++_last_run;
+	size_t so = begin_record(RUN, run);
+	put<uint8_t>(kind);
+	end_record(so);
+	return run;
+}
+
+void TraceFile::fc_inference(uint64_t run, unsigned iteration,
+                             const Handle& rule, const Handle& source,
+                             const HandleSet& product)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (not sample())
+		return;
+
+	uint64_t rule_hash = atom(rule);
+	uint64_t source_hash = atom(source);
+	std::vector<uint64_t> product_hashes;
+	product_hashes.reserve(product.size());
+	for (const Handle& h : product)
+		product_hashes.push_back(atom(h));
+
+	size_t so = begin_record(FC_INFERENCE, run);
+	put<uint32_t>(iteration);
+	put(rule_hash);
+	put(source_hash);
+	put<uint32_t>(product_hashes.size());
+	for (uint64_t hash : product_hashes)
+		put(hash);
+	end_record(so);
+}
+
+void TraceFile::bc_target(uint64_t run, const Handle& target)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	uint64_t target_hash = atom(target);
+	size_t so = begin_record(BC_TARGET, run);
+	put(target_hash);
+	end_record(so);
+}
+
+void TraceFile::bc_andbit(uint64_t run, const Handle& andbit_fcs)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (not sample())
+		return;
+
+	uint64_t fcs_hash = atom(andbit_fcs);
+	size_t so = begin_record(BC_ANDBIT, run);
+	put(fcs_hash);
+	end_record(so);
+}
+
+void TraceFile::bc_expansion(uint64_t run, const Handle& andbit_fcs,
+                             const Handle& bitleaf_body, const Handle& rule,
+                             const Handle& new_andbit_fcs)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (not sample())
+		return;
+
+	uint64_t fcs_hash = atom(andbit_fcs);
+	uint64_t body_hash = atom(bitleaf_body);
+	uint64_t rule_hash = atom(rule);
+	uint64_t new_fcs_hash = atom(new_andbit_fcs);
+	size_t so = begin_record(BC_EXPANSION, run);
+	put(fcs_hash);
+	put(body_hash);
+	put(rule_hash);
+	put(new_fcs_hash);
+	end_record(so);
+}
+
+void TraceFile::bc_proof(uint64_t run, const Handle& andbit_fcs,
+                         const Handle& target_result)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (not sample())
+		return;
+
+	uint64_t fcs_hash = atom(andbit_fcs);
+	uint64_t result_hash = atom(target_result);
+	TruthValuePtr tv = target_result->getTruthValue();
+	size_t so = begin_record(BC_PROOF, run);
+	put(fcs_hash);
+	put(result_hash);
+	put<double>(tv->get_mean());
+	put<double>(tv->get_confidence());
+	end_record(so);
+}
+
+void TraceFile::flush()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_file.write(_buffer.data(), _buffer.size());
+	_file.flush();
+	_buffer.clear();
+}
+
+bool TraceFile::sample()
+{
+	return _submitted++ % _sampling == 0;
+}
+
+uint64_t TraceFile::atom(const Handle& h)
+{
+	if (not h)
+		return 0;
+
+	uint64_t hash = h->get_hash();
+	if (_written.insert(hash).second) {
+		std::string sexpr = h->to_short_string();
+		size_t so = begin_record(ATOM, 0);
+		put(hash);
+		_buffer.insert(_buffer.end(), sexpr.begin(), sexpr.end());
+		end_record(so);
+	}
+	return hash;
+}
+
+size_t TraceFile::begin_record(RecordType type, uint64_t run)
+{
+	put<uint8_t>(type);
+	put(run);
+	size_t size_offset = _buffer.size();
+	put<uint32_t>(0);
+	return size_offset;
+}
+
+void TraceFile::end_record(size_t size_offset)
+{
+	uint32_t size = _buffer.size() - size_offset - sizeof(uint32_t);
+	std::memcpy(_buffer.data() + size_offset, &size, sizeof(size));
+
+	if (flush_threshold <= _buffer.size()) {
+		_file.write(_buffer.data(), _buffer.size());
+		_buffer.clear();
+	}
+}
+
+static std::shared_ptr<TraceFile> _ure_trace_file;
+static std::mutex _ure_trace_file_mutex;
+
+void opencog::set_ure_trace_file(const std::string& filename, unsigned sampling)
+{
+	std::lock_guard<std::mutex> lock(_ure_trace_file_mutex);
+	if (filename.empty())
+		_ure_trace_file.reset();
+	else if (_ure_trace_file and _ure_trace_file->get_filename() == filename)
+		// Do not open the same file twice, as their records would
+		// get interleaved
+		_ure_trace_file->set_sampling(sampling);
+	else
+		_ure_trace_file = std::make_shared<TraceFile>(filename, sampling);
+}
+
+std::shared_ptr<TraceFile> opencog::ure_trace_file()
+{
+	std::lock_guard<std::mutex> lock(_ure_trace_file_mutex);
+	return _ure_trace_file;
+}
@@ -0,0 +1,198 @@
+/*
+ * TraceFile.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_URE_TRACE_FILE_H_
+#define _OPENCOG_URE_TRACE_FILE_H_
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <opencog/atoms/base/Handle.h>
+
+namespace opencog
+{
+
+/**
+ * Append-only binary file recording the inference traces of the
+ * forward and backward chainers, as a compact alternative to the
+ * trace atomspace. Records refer to atoms by content hash, the
+ * s-expression of each atom being written once, the first time it
+ * is referred to, in an atom record. The script
+ * scripts/ure/trace-to-scm.py converts such a file back into the
+ * trace atoms that FCStat and TraceRecorder would have created.
+ *
+ * The file starts with the 8 bytes "URETRACE" followed by the
+ * format version as uint32, then is a sequence of records
+ *
+ * uint8  type
+ * uint64 run
+ * uint32 size
+ * <size bytes of payload>
+ *
+ * where run identifies the chainer the record originates from (0
+ * for atom records), as several chainers may be tracing to the same
+ * file at the same time. Its upper 32 bits identify the session,
+ * that is the TraceFile that opened the file, drawn at random, and
+ * its lower 32 bits number the runs of that session from 1, so that
+ * the runs of sessions appending to the same file do not get mixed
+ * up. Integers and doubles are in host byte order, hashes are
+ * uint64. The payload of each type of record is described in
+ * RecordType.
+ *
+ * Atoms are identified by their 64-bit content hash alone, assuming
+ * that no two atoms of a file share the same hash, the odds of which
+ * remain below 1e-7 under a million distinct atoms. The converter
+ * fails if it meets two atom records of the same hash and different
+ * s-expressions, which can only happen across sessions, as an atom
+ * is only written once per session.
+ *
+ * If sampling is N > 1, only 1 in N inference records (FC
+ * inferences, BC and-BITs, expansions and proofs) is written, which
+ * bounds the size of the file, at the cost of partial traces. Atom,
+ * run and target records are always written.
+ */
+class TraceFile
+{
+public:
+	enum RecordType : uint8_t {
+		// uint64 hash, then the s-expression of the atom
+		ATOM = 1,
+		// uint8 kind (see RunKind)
+		RUN,
+		// uint32 iteration, uint64 rule alias, uint64 source,
+		// uint32 count, then count uint64 products
+		FC_INFERENCE,
+		// uint64 target
+		BC_TARGET,
+		// uint64 and-BIT fcs
+		BC_ANDBIT,
+		// uint64 and-BIT fcs, uint64 bitleaf body, uint64 rule alias,
+		// uint64 new and-BIT fcs
+		BC_EXPANSION,
+		// uint64 and-BIT fcs, uint64 target result, double strength,
+		// double confidence
+		BC_PROOF
+	};
+
+	enum RunKind : uint8_t { FC = 0, BC = 1 };
+
+	static const char magic[8];
+	static const uint32_t version;
+
+	/**
+	 * Open filename for appending, and write the file header if it
+	 * is empty. Throw a RuntimeException if it cannot be opened, or
+	 * is not a trace file of the current version.
+	 */
+	TraceFile(const std::string& filename, unsigned sampling = 1);
+	~TraceFile();
+
+	const std::string& get_filename() const;
+
+	void set_sampling(unsigned sampling);
+	unsigned get_sampling() const;
+
+	/**
+	 * Record the start of a chainer run, and return its identifier,
+	 * to be passed to the subsequent records of that run.
+	 */
+	uint64_t run(RunKind kind);
+
+	void fc_inference(uint64_t run, unsigned iteration,
+	                  const Handle& rule, const Handle& source,
+	                  const HandleSet& product);
+
+	void bc_target(uint64_t run, const Handle& target);
+	void bc_andbit(uint64_t run, const Handle& andbit_fcs);
+	void bc_expansion(uint64_t run, const Handle& andbit_fcs,
+	                  const Handle& bitleaf_body, const Handle& rule,
+	                  const Handle& new_andbit_fcs);
+	void bc_proof(uint64_t run, const Handle& andbit_fcs,
+	              const Handle& target_result);
+
+	/**
+	 * Write the buffered records to the file.
+	 */
+	void flush();
+
+private:
+	std::string _filename;
+	std::ofstream _file;
+	unsigned _sampling;
+
+	// Number of inference records submitted so far, used for sampling
+	uint64_t _submitted;
+
+	// Identifier of the session, upper 32 bits of its run
+	// identifiers, and number of its last run
+	uint32_t _session;
+	uint32_t _last_run;
+
+	// Hashes of the atoms already written in an atom record
+	std::unordered_set<uint64_t> _written;
+
+	// Records pending to be written to _file
+	std::vector<char> _buffer;
+
+	mutable std::mutex _mutex;
+
+	// Return true if the next inference record should be written.
+	// Must be called under lock.
+	bool sample();
+
+	// Write the atom record of h, if not written already, and return
+	// its hash. Must be called under lock.
+	uint64_t atom(const Handle& h);
+
+	// Append a record header to _buffer, and return the offset of its
+	// size field, to be filled by end_record. Must be called under lock.
+	size_t begin_record(RecordType type, uint64_t run);
+	void end_record(size_t size_offset);
+
+	template<typename T>
+	void put(const T& value)
+	{
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		_buffer.insert(_buffer.end(), bytes, bytes + sizeof(T));
+	}
+};
+
+/**
+ * Set the trace file subsequently created chainers write to, in
+ * addition to their trace atomspace if any. An empty filename
+ * disables it. The file remains open as long as some chainer
+ * writes to it.
+ */
+void set_ure_trace_file(const std::string& filename, unsigned sampling = 1);
+
+/**
+ * Return the trace file set by set_ure_trace_file, nullptr if none.
+ */
+std::shared_ptr<TraceFile> ure_trace_file();
+
+} // namespace opencog
+
+#endif /* _OPENCOG_URE_TRACE_FILE_H_ */
@@ -41,16 +41,44 @@ const std::string UREConfig::jobs_name =
 	"URE:jobs";
 const std::string UREConfig::expansion_pool_size_name =
 	"URE:expansion-pool-size";
+const std::string UREConfig::subsumption_pruning_name =
+	"URE:subsumption-pruning";
+const std::string UREConfig::collect_stats_name =
+	"URE:collect-stats";
 const std::string UREConfig::fc_retry_exhausted_sources_name =
 	"URE:FC:retry-exhausted-sources";
 const std::string UREConfig::fc_full_rule_application_name =
 	"URE:FC:full-rule-application";
+const std::string UREConfig::fc_inference_record_limit_name =
+	"URE:FC:inference-record-limit";
 const std::string UREConfig::bc_max_bit_size_name =
 	"URE:BC:maximum-bit-size";
 const std::string UREConfig::bc_mm_complexity_penalty_name =
 	"URE:BC:MM:complexity-penalty";
 const std::string UREConfig::bc_mm_compressiveness_name =
 	"URE:BC:MM:compressiveness";
+const std::string UREConfig::bc_fulfillment_jobs_name =
+	"URE:BC:fulfillment-jobs";
+const std::string UREConfig::bc_fulfillment_queue_size_name =
+	"URE:BC:fulfillment-queue-size";
+const std::string UREConfig::bc_fulfillment_batch_size_name =
+	"URE:BC:fulfillment-batch-size";
+const std::string UREConfig::bc_target_decomposition_name =
+	"URE:BC:target-decomposition";
+const std::string UREConfig::bc_best_first_name =
+	"URE:BC:best-first";
+const std::string UREConfig::bc_iterative_deepening_name =
+	"URE:BC:iterative-deepening";
+const std::string UREConfig::bc_beam_width_name =
+	"URE:BC:beam-width";
+const std::string UREConfig::bc_confidence_threshold_name =
+	"URE:BC:confidence-threshold";
+const std::string UREConfig::bc_result_count_name =
+	"URE:BC:result-count";
+const std::string UREConfig::bc_rule_pruning_name =
+	"URE:BC:rule-pruning";
+const std::string UREConfig::bc_maximum_subtarget_instances_name =
+	"URE:BC:maximum-subtarget-instances";
 
 UREConfig::UREConfig(AtomSpace& as, const Handle& rbs) : _as(as)
 {
@@ -63,6 +91,15 @@ UREConfig::UREConfig(AtomSpace& as, const Handle& rbs) : _as(as)
 	fetch_bc_parameters(rbs);
 }
 
+void UREConfig::set_parameters(const UREConfig& other)
+{
+	RuleSet rules(_common_params.rules);
+	_common_params = other._common_params;
+	_common_params.rules = rules;
+	_fc_params = other._fc_params;
+	_bc_params = other._bc_params;
+}
+
 const RuleSet& UREConfig::get_rules() const
 {
 	return _common_params.rules;
@@ -93,6 +130,16 @@ int UREConfig::get_expansion_pool_size() const
 	return _common_params.expansion_pool_size;
 }
 
+bool UREConfig::get_subsumption_pruning() const
+{
+	return _common_params.subsumption_pruning;
+}
+
+bool UREConfig::get_collect_stats() const
+{
+	return _common_params.collect_stats;
+}
+
 bool UREConfig::get_retry_exhausted_sources() const
 {
 	return _fc_params.retry_exhausted_sources;
@@ -103,6 +150,11 @@ bool UREConfig::get_full_rule_application() const
 	return _fc_params.full_rule_application;
 }
 
+int UREConfig::get_inference_record_limit() const
+{
+	return _fc_params.inference_record_limit;
+}
+
 double UREConfig::get_max_bit_size() const
 {
 	return _bc_params.max_bit_size;
@@ -118,6 +170,61 @@ double UREConfig::get_mm_compressiveness() const
 	return _bc_params.mm_compressiveness;
 }
 
+int UREConfig::get_fulfillment_jobs() const
+{
+	return _bc_params.fulfillment_jobs;
+}
+
+int UREConfig::get_fulfillment_queue_size() const
+{
+	return _bc_params.fulfillment_queue_size;
+}
+
+int UREConfig::get_fulfillment_batch_size() const
+{
+	return _bc_params.fulfillment_batch_size;
+}
+
+bool UREConfig::get_target_decomposition() const
+{
+	return _bc_params.target_decomposition;
+}
+
+bool UREConfig::get_best_first() const
+{
+	return _bc_params.best_first;
+}
+
+bool UREConfig::get_iterative_deepening() const
+{
+	return _bc_params.iterative_deepening;
+}
+
+int UREConfig::get_beam_width() const
+{
+	return _bc_params.beam_width;
+}
+
+double UREConfig::get_confidence_threshold() const
+{
+	return _bc_params.confidence_threshold;
+}
+
+int UREConfig::get_result_count() const
+{
+	return _bc_params.result_count;
+}
+
+bool UREConfig::get_rule_pruning() const
+{
+	return _bc_params.rule_pruning;
+}
+
+int UREConfig::get_maximum_subtarget_instances() const
+{
+	return _bc_params.maximum_subtarget_instances;
+}
+
 std::string UREConfig::get_maximum_iterations_str() const
 {
 	if (_common_params.max_iter < 0)
@@ -145,6 +252,16 @@ void UREConfig::set_expansion_pool_size(int eps)
 	_common_params.expansion_pool_size = eps;
 }
 
+void UREConfig::set_subsumption_pruning(bool sp)
+{
+	_common_params.subsumption_pruning = sp;
+}
+
+void UREConfig::set_collect_stats(bool cs)
+{
+	_common_params.collect_stats = cs;
+}
+
 void UREConfig::set_retry_exhausted_sources(bool rs)
 {
 	_fc_params.retry_exhausted_sources = rs;
@@ -155,6 +272,11 @@ void UREConfig::set_full_rule_application(bool rs)
 	_fc_params.full_rule_application = rs;
 }
 
+void UREConfig::set_inference_record_limit(int v)
+{
+	_fc_params.inference_record_limit = v;
+}
+
 void UREConfig::set_mm_complexity_penalty(double mm_cp)
 {
 	_bc_params.mm_complexity_penalty = mm_cp;
@@ -165,6 +287,61 @@ void UREConfig::set_mm_compressiveness(double mm_cpr)
 	_bc_params.mm_complexity_penalty = mm_cpr;
 }
 
+void UREConfig::set_fulfillment_jobs(int fj)
+{
+	_bc_params.fulfillment_jobs = fj;
+}
+
+void UREConfig::set_fulfillment_queue_size(int fqs)
+{
+	_bc_params.fulfillment_queue_size = fqs;
+}
+
+void UREConfig::set_fulfillment_batch_size(int fbs)
+{
+	_bc_params.fulfillment_batch_size = fbs;
+}
+
+void UREConfig::set_target_decomposition(bool td)
+{
+	_bc_params.target_decomposition = td;
+}
+
+void UREConfig::set_best_first(bool bf)
+{
+	_bc_params.best_first = bf;
+}
+
+void UREConfig::set_iterative_deepening(bool id)
+{
+	_bc_params.iterative_deepening = id;
+}
+
+void UREConfig::set_beam_width(int bw)
+{
+	_bc_params.beam_width = bw;
+}
+
+void UREConfig::set_confidence_threshold(double ct)
+{
+	_bc_params.confidence_threshold = ct;
+}
+
+void UREConfig::set_result_count(int rc)
+{
+	_bc_params.result_count = rc;
+}
+
+void UREConfig::set_rule_pruning(bool rp)
+{
+	_bc_params.rule_pruning = rp;
+}
+
+void UREConfig::set_maximum_subtarget_instances(int msi)
+{
+	_bc_params.maximum_subtarget_instances = msi;
+}
+
 HandleSeq UREConfig::fetch_rule_names(const Handle& rbs)
 {
 	// Retrieve rules
@@ -209,6 +386,14 @@ void UREConfig::fetch_common_parameters(const Handle& rbs)
 	// Fetch production application ratio
 	_common_params.expansion_pool_size =
 		fetch_num_param(expansion_pool_size_name, rbs, 1);
+
+	// Fetch subsumption pruning parameter
+	_common_params.subsumption_pruning =
+		fetch_bool_param(subsumption_pruning_name, rbs, false);
+
+	// Fetch collect stats parameter
+	_common_params.collect_stats =
+		fetch_bool_param(collect_stats_name, rbs, false);
 }
 
 void UREConfig::fetch_fc_parameters(const Handle& rbs)
@@ -218,6 +403,10 @@ void UREConfig::fetch_fc_parameters(const Handle& rbs)
 		fetch_bool_param(fc_retry_exhausted_sources_name, rbs, false);
 	_fc_params.full_rule_application =
 		fetch_bool_param(fc_full_rule_application_name, rbs, false);
+
+	// Fetch inference record limit parameter
+	_fc_params.inference_record_limit =
+		fetch_num_param(fc_inference_record_limit_name, rbs, -1);
 }
 
 void UREConfig::fetch_bc_parameters(const Handle& rbs)
@@ -232,6 +421,50 @@ void UREConfig::fetch_bc_parameters(const Handle& rbs)
 	// Fetch BC Mixture Model compressiveness parameter
 	_bc_params.mm_compressiveness =
 		fetch_num_param(bc_mm_compressiveness_name, rbs, 1);
+
+	// Fetch BC number of asynchronous fulfillment jobs
+	_bc_params.fulfillment_jobs =
+		fetch_num_param(bc_fulfillment_jobs_name, rbs, 0);
+
+	// Fetch BC maximum number of and-BITs pending fulfillment
+	_bc_params.fulfillment_queue_size =
+		fetch_num_param(bc_fulfillment_queue_size_name, rbs, 100);
+
+	// Fetch BC fulfillment batch size
+	_bc_params.fulfillment_batch_size =
+		fetch_num_param(bc_fulfillment_batch_size_name, rbs, 0);
+
+	// Fetch BC target decomposition
+	_bc_params.target_decomposition =
+		fetch_bool_param(bc_target_decomposition_name, rbs, false);
+
+	// Fetch BC best-first
+	_bc_params.best_first =
+		fetch_bool_param(bc_best_first_name, rbs, false);
+
+	// Fetch BC iterative deepening
+	_bc_params.iterative_deepening =
+		fetch_bool_param(bc_iterative_deepening_name, rbs, false);
+
+	// Fetch BC beam width
+	_bc_params.beam_width =
+		fetch_num_param(bc_beam_width_name, rbs, 0);
+
+	// Fetch BC confidence threshold
+	_bc_params.confidence_threshold =
+		fetch_num_param(bc_confidence_threshold_name, rbs, -1);
+
+	// Fetch BC result count
+	_bc_params.result_count =
+		fetch_num_param(bc_result_count_name, rbs, 1);
+
+	// Fetch BC rule pruning
+	_bc_params.rule_pruning =
+		fetch_bool_param(bc_rule_pruning_name, rbs, false);
+
+	// Fetch maximum subtarget instances parameter
+	_bc_params.maximum_subtarget_instances =
+		fetch_num_param(bc_maximum_subtarget_instances_name, rbs, 8);
 }
 
 HandleSeq UREConfig::fetch_execution_outputs(const Handle& schema,
@@ -53,6 +53,11 @@ public:
 	// rbs is a Handle pointing to a rule-based system is as
 	UREConfig(AtomSpace& as, const Handle& rbs);
 
+	// Copy the parameters of another configuration, all but the
+	// rules, so that the rules of each configuration remain distinct
+	// objects.
+	void set_parameters(const UREConfig& other);
+
 	///////////////
 	// Accessors //
 	///////////////
@@ -64,13 +69,27 @@ public:
 	double get_complexity_penalty() const;
 	int get_jobs() const;
 	int get_expansion_pool_size() const;
+	bool get_subsumption_pruning() const;
+	bool get_collect_stats() const;
 	// FC
 	bool get_retry_exhausted_sources() const;
 	bool get_full_rule_application() const;
+	int get_inference_record_limit() const;
 	// BC
 	double get_max_bit_size() const;
 	double get_mm_complexity_penalty() const;
 	double get_mm_compressiveness() const;
+	int get_fulfillment_jobs() const;
+	int get_fulfillment_queue_size() const;
+	int get_fulfillment_batch_size() const;
+	bool get_target_decomposition() const;
+	bool get_best_first() const;
+	bool get_iterative_deepening() const;
+	int get_beam_width() const;
+	double get_confidence_threshold() const;
+	int get_result_count() const;
+	bool get_rule_pruning() const;
+	int get_maximum_subtarget_instances() const;
 
 	// Display
 	std::string get_maximum_iterations_str() const; // "+inf" if negative
@@ -85,12 +104,26 @@ public:
 	void set_complexity_penalty(double);
 	void set_jobs(int);
 	void set_expansion_pool_size(int);
+	void set_subsumption_pruning(bool);
+	void set_collect_stats(bool);
 	// FC
 	void set_retry_exhausted_sources(bool);
 	void set_full_rule_application(bool);
+	void set_inference_record_limit(int);
 	// BC
 	void set_mm_complexity_penalty(double);
 	void set_mm_compressiveness(double);
+	void set_fulfillment_jobs(int);
+	void set_fulfillment_queue_size(int);
+	void set_fulfillment_batch_size(int);
+	void set_target_decomposition(bool);
+	void set_best_first(bool);
+	void set_iterative_deepening(bool);
+	void set_beam_width(int);
+	void set_confidence_threshold(double);
+	void set_result_count(int);
+	void set_rule_pruning(bool);
+	void set_maximum_subtarget_instances(int);
 
 	//////////////////
 	// Constants    //
@@ -114,6 +147,14 @@ public:
 	// Name of the production application ratio parameter
 	static const std::string expansion_pool_size_name;
 
+	// Name of the PredicateNode outputting whether new sources (resp.
+	// and-BITs) that are instances of existing ones should be discarded
+	static const std::string subsumption_pruning_name;
+
+	// Name of the PredicateNode outputting whether profiling counters of
+	// the chainer (see ChainerStats) should be recorded
+	static const std::string collect_stats_name;
+
 	// Name of the PredicateNode outputting whether sources should be
 	// retried after exhaustion
 	static const std::string fc_retry_exhausted_sources_name;
@@ -123,6 +164,9 @@ public:
 	// source.
 	static const std::string fc_full_rule_application_name;
 
+	// Name of the maximum number of inference records kept in memory
+	static const std::string fc_inference_record_limit_name;
+
 	// Name of the maximum number of and-BITs in the BIT parameter
 	static const std::string bc_max_bit_size_name;
 
@@ -134,6 +178,40 @@ public:
 	// much unexplained data are compressed
 	static const std::string bc_mm_compressiveness_name;
 
+	// Name of the number of asynchronous fulfillment jobs parameter
+	static const std::string bc_fulfillment_jobs_name;
+
+	// Name of the maximum number of and-BITs pending fulfillment
+	// parameter
+	static const std::string bc_fulfillment_queue_size_name;
+
+	// Name of the fulfillment batch size parameter
+	static const std::string bc_fulfillment_batch_size_name;
+
+	// Name of the target decomposition parameter
+	static const std::string bc_target_decomposition_name;
+
+	// Name of the best-first parameter
+	static const std::string bc_best_first_name;
+
+	// Name of the iterative deepening parameter
+	static const std::string bc_iterative_deepening_name;
+
+	// Name of the beam width parameter
+	static const std::string bc_beam_width_name;
+
+	// Name of the confidence threshold parameter
+	static const std::string bc_confidence_threshold_name;
+
+	// Name of the result count parameter
+	static const std::string bc_result_count_name;
+
+	// Name of the rule pruning parameter
+	static const std::string bc_rule_pruning_name;
+
+	// Name of the maximum subtarget instances parameter
+	static const std::string bc_maximum_subtarget_instances_name;
+
 private:
 	AtomSpace& _as;
 
@@ -151,7 +229,9 @@ private:
 		double complexity_penalty;
 
 		// This parameter controls the number of jobs used during
-		// reasoning.
+		// reasoning. In the backward chainer it corresponds to the
+		// number of and-BITs expanded and fulfilled in parallel at
+		// each step.
 		int jobs;
 
 		// This parameter controls how much the expension pool is
@@ -160,6 +240,12 @@ private:
 		// iterative forward chainer), but also then the selection is
 		// more costly. Negative means unlimited.
 		int expansion_pool_size;
+
+		// Discard sources and and-BITs subsumed by existing ones
+		bool subsumption_pruning;
+
+		// Record profiling counters of the chainer
+		bool collect_stats;
 	};
 	CommonParameters _common_params;
 
@@ -171,6 +257,10 @@ private:
 		// Apply the selected rule over the entire atomspace, not just
 		// the selected source.
 		bool full_rule_application;
+
+		// Maximum number of inference records kept in memory, negative
+		// means unbounded
+		int inference_record_limit;
 };
 	FCParameters _fc_params;
 
@@ -191,6 +281,53 @@ private:
 		// unexplained data are compressed. The compressed unexplained
 		// data are added to the model complexity.
 		double mm_compressiveness;
+
+		// Number of worker threads fulfilling and-BITs asynchronously,
+		// while the BIT keeps being expanded. 0 means that and-BITs are
+		// fulfilled synchronously right after being produced.
+		int fulfillment_jobs;
+
+		// Maximum number of and-BITs pending fulfillment when
+		// fulfillment is asynchronous. Expansion blocks when reached.
+		int fulfillment_queue_size;
+
+		// Number of and-BITs accumulated before being fulfilled together,
+		// sharing the execution of their common clauses. 0 or 1 means
+		// that each and-BIT is fulfilled on its own.
+		int fulfillment_batch_size;
+
+		// Whether a conjunctive target should be decomposed into sub-targets
+		// solved by sub-chainers before the whole target is solved.
+		bool target_decomposition;
+
+		// Whether and-BITs should be selected for expansion deterministically,
+		// by increasing estimated cost, rather than sampled.
+		bool best_first;
+
+		// Whether and-BITs should be selected for expansion depth-first
+		// within a cost bound, increased when no and-BIT is within it.
+		bool iterative_deepening;
+
+		// Number of and-BITs kept in the BIT by beam search. 0 or a negative
+		// value means that beam search is disabled.
+		int beam_width;
+
+		// Minimum confidence of the results counting toward the result count
+		// termination criterion. Negative means that criterion is disabled.
+		double confidence_threshold;
+
+		// Number of results with a confidence above the confidence threshold
+		// after which the backward chainer terminates.
+		int result_count;
+
+		// Whether rules with no path back to the knowledge-base, according to
+		// the rule dependency graph, should be discarded before chaining.
+		bool rule_pruning;
+
+		// Maximum number of instances of a conjunct, given the groundings of its
+		// prefix, solved by sub-chainers during target decomposition. Negative
+		// means unlimited.
+		int maximum_subtarget_instances;
 	};
 	BCParameters _bc_params;
 
@@ -264,10 +401,10 @@ private:
 	                     const std::string& param_name,
 	                     const T& value, bool is_default=false) const
 	{
-		ure_logger().debug() << "Rule-base " << rbs_input->get_name()
-		                     << ", set parameter " << param_name
-		                     << " to " << value
-		                     << (is_default ? " [default]" : "");
+		LAZY_URE_LOG_DEBUG << "Rule-base " << rbs_input->get_name()
+		                   << ", set parameter " << param_name
+		                   << " to " << value
+		                   << (is_default ? " [default]" : "");
 	}
 };
 
@@ -0,0 +1,278 @@
+/*
+ * URELogSink.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+
+#include "URELogger.h"
+#include "URELogSink.h"
+
+namespace opencog {
+
+const size_t URELogSink::default_buffer_size = 16384;
+
+// Period of the writer thread
+static const std::chrono::milliseconds writer_period(10);
+
+/**
+ * Single producer single consumer lock-free ring buffer. The producer
+ * is the thread owning it, the consumer is the draining thread.
+ */
+struct URELogRing
+{
+	URELogRing(size_t size) : entries(size + 1), head(0), tail(0),
+	                          pending(no_pending), retired(false) {}
+
+	bool push(URELogEntry&& entry)
+	{
+		size_t h = head.load(std::memory_order_relaxed);
+		size_t next = (h + 1) % entries.size();
+		if (next == tail.load(std::memory_order_acquire))
+			return false;
+		entries[h] = std::move(entry);
+		head.store(next, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(URELogEntry& entry)
+	{
+		size_t t = tail.load(std::memory_order_relaxed);
+		if (t == head.load(std::memory_order_acquire))
+			return false;
+		entry = std::move(entries[t]);
+		entries[t].msg = std::string();
+		tail.store((t + 1) % entries.size(), std::memory_order_release);
+		return true;
+	}
+
+	bool empty() const
+	{
+		return head.load(std::memory_order_acquire)
+			== tail.load(std::memory_order_acquire);
+	}
+
+	size_t capacity() const
+	{
+		return entries.size() - 1;
+	}
+
+	std::vector<URELogEntry> entries;
+	std::atomic<size_t> head;   // Next entry to push
+	std::atomic<size_t> tail;   // Next entry to pop
+
+	// Lower bound of the sequence number of the entry being pushed by
+	// the owning thread, if any, no_pending otherwise.
+	static const uint64_t no_pending = UINT64_MAX;
+	std::atomic<uint64_t> pending;
+
+	// Set when the owning thread has exited, so that the ring can be
+	// discarded once drained.
+	std::atomic<bool> retired;
+};
+
+// Hold the ring buffer of a thread, retire it when the thread exits
+struct URELogRingHolder
+{
+	~URELogRingHolder()
+	{
+		if (ring)
+			ring->retired = true;
+	}
+
+	std::shared_ptr<URELogRing> ring;
+};
+
+static thread_local URELogRingHolder local_ring_holder;
+
+URELogSink::URELogSink()
+	: _async(false), _buffer_size(default_buffer_size), _sequence(0),
+	  _dropped(0), _reported_dropped(0), _stop_writer(false)
+{
+	// Make sure the logger outlives the sink
+	ure_logger();
+}
+
+URELogSink::~URELogSink()
+{
+	stop_writer();
+	drain();
+}
+
+void URELogSink::set_async(bool async)
+{
+	if (async) {
+		start_writer();
+		_async = true;
+	} else {
+		_async = false;
+		stop_writer();
+		flush();
+	}
+}
+
+bool URELogSink::is_async() const
+{
+	return _async.load(std::memory_order_relaxed);
+}
+
+void URELogSink::set_buffer_size(size_t size)
+{
+	_buffer_size = std::max((size_t)1, size);
+}
+
+size_t URELogSink::get_buffer_size() const
+{
+	return _buffer_size;
+}
+
+void URELogSink::log(Logger::Level level, std::string&& msg)
+{
+	// Announce the entry before taking its sequence number, so that
+	// drain does not write the entries logged after it before it.
+	URELogRing& ring = local_ring();
+	ring.pending = _sequence.load();
+	URELogEntry entry{_sequence++, level, std::move(msg)};
+	if (not ring.push(std::move(entry)))
+		_dropped++;
+	ring.pending = URELogRing::no_pending;
+}
+
+void URELogSink::flush()
+{
+	drain();
+	ure_logger().flush();
+}
+
+uint64_t URELogSink::get_dropped_count() const
+{
+	return _dropped;
+}
+
+URELogRing& URELogSink::local_ring()
+{
+	std::shared_ptr<URELogRing>& ring = local_ring_holder.ring;
+	size_t size = _buffer_size;
+	if (not ring or ring->capacity() != size) {
+		// Retire the ring buffer of the former capacity, if any, so
+		// that it is discarded once drained
+		if (ring)
+			ring->retired = true;
+		ring = std::make_shared<URELogRing>(size);
+		std::lock_guard<std::mutex> lock(_rings_mutex);
+		_rings.push_back(ring);
+	}
+	return *ring;
+}
+
+void URELogSink::drain()
+{
+	std::lock_guard<std::mutex> drain_lock(_drain_mutex);
+
+	// Only the messages numbered below cutoff can be written, as
+	// any message numbered below it is either in a ring buffer or
+	// announced as pending by its thread. The rings are copied after
+	// reading _sequence, thus include the ones of these threads.
+	uint64_t cutoff = _sequence.load();
+	std::vector<std::shared_ptr<URELogRing>> rings;
+	{
+		std::lock_guard<std::mutex> lock(_rings_mutex);
+		rings = _rings;
+	}
+	for (const auto& ring : rings)
+		cutoff = std::min(cutoff, ring->pending.load());
+
+	// Collect the pending messages of all threads, along with the
+	// ones held back by the previous drain, and restore their order
+	std::vector<URELogEntry> entries(std::move(_held));
+	_held.clear();
+	URELogEntry entry;
+	for (const auto& ring : rings)
+		while (ring->pop(entry))
+			entries.push_back(std::move(entry));
+	std::sort(entries.begin(), entries.end(),
+	          [](const URELogEntry& l, const URELogEntry& r) {
+		          return l.sequence < r.sequence; });
+
+	auto held = std::find_if(entries.begin(), entries.end(),
+	                         [&](const URELogEntry& e) {
+		                         return cutoff <= e.sequence; });
+	for (auto it = entries.begin(); it != held; ++it)
+		ure_logger().log(it->level, it->msg);
+	_held.assign(std::make_move_iterator(held),
+	             std::make_move_iterator(entries.end()));
+
+	uint64_t dropped = _dropped;
+	if (_reported_dropped < dropped) {
+		ure_logger().warn() << dropped - _reported_dropped
+		                    << " URE log messages have been dropped, "
+		                    << "consider increasing the buffer size";
+		_reported_dropped = dropped;
+	}
+
+	// Discard the drained ring buffers of the exited threads
+	std::lock_guard<std::mutex> lock(_rings_mutex);
+	_rings.erase(std::remove_if(_rings.begin(), _rings.end(),
+	                            [](const std::shared_ptr<URELogRing>& ring) {
+		                            return ring->retired and ring->empty(); }),
+	             _rings.end());
+}
+
+void URELogSink::start_writer()
+{
+	std::lock_guard<std::mutex> lock(_writer_mutex);
+	if (_writer.joinable())
+		return;
+	_stop_writer = false;
+	_writer = std::thread(&URELogSink::writer_loop, this);
+}
+
+void URELogSink::stop_writer()
+{
+	{
+		std::lock_guard<std::mutex> lock(_writer_mutex);
+		if (not _writer.joinable())
+			return;
+		_stop_writer = true;
+	}
+	_writer_cv.notify_all();
+	_writer.join();
+}
+
+void URELogSink::writer_loop()
+{
+	std::unique_lock<std::mutex> lock(_writer_mutex);
+	while (not _stop_writer) {
+		_writer_cv.wait_for(lock, writer_period);
+		lock.unlock();
+		drain();
+		lock.lock();
+	}
+}
+
+URELogSink& ure_log_sink()
+{
+	static URELogSink ure_log_sink_instance;
+	return ure_log_sink_instance;
+}
+
+} // ~namespace opencog
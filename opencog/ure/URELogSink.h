@@ -0,0 +1,151 @@
+/*
+ * URELogSink.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_URE_LOG_SINK_H_
+#define _OPENCOG_URE_LOG_SINK_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencog/util/Logger.h>
+
+namespace opencog
+{
+
+struct URELogRing;
+
+struct URELogEntry
+{
+	uint64_t sequence;
+	Logger::Level level;
+	std::string msg;
+};
+
+/**
+ * Asynchronous sink of the URE log messages. When enabled, messages
+ * logged via the LAZY_URE_LOG_* macros are pushed, without locking,
+ * into a ring buffer owned by the logging thread, and written to
+ * ure_logger() by a background thread. So that logging, at debug
+ * level for instance, does not slow down the chainers as much, nor
+ * alter their behavior by the same token.
+ *
+ * Memory is bounded by the size of the ring buffers (number of
+ * messages per thread). When the ring buffer of a thread is full,
+ * its new messages are dropped and counted, see get_dropped_count.
+ *
+ * Messages are written in the order they were logged, across threads
+ * and drains. A message is held back till a later drain while a
+ * message logged before it, by another thread, is not in its ring
+ * buffer yet. Their timestamps however are the ones of writing.
+ */
+class URELogSink
+{
+public:
+	URELogSink();
+	~URELogSink();
+
+	/**
+	 * Enable or disable asynchronous logging. When disabled, pending
+	 * messages are written before returning, and subsequent messages
+	 * are directly passed to ure_logger().
+	 */
+	void set_async(bool async);
+	bool is_async() const;
+
+	/**
+	 * Set the capacity, in messages, of the ring buffers. A thread
+	 * that has already logged replaces its ring buffer by one of the
+	 * new capacity at its next message, the former one is discarded
+	 * once drained.
+	 */
+	void set_buffer_size(size_t size);
+	size_t get_buffer_size() const;
+
+	/**
+	 * Push a message into the ring buffer of the calling thread, or
+	 * drop it if full.
+	 */
+	void log(Logger::Level level, std::string&& msg);
+
+	/**
+	 * Write all pending messages and flush ure_logger().
+	 */
+	void flush();
+
+	/**
+	 * Return the total number of dropped messages.
+	 */
+	uint64_t get_dropped_count() const;
+
+	// Default capacity of the ring buffers
+	static const size_t default_buffer_size;
+
+private:
+	// Return the ring buffer of the calling thread, create and
+	// register it if needed.
+	URELogRing& local_ring();
+
+	// Write all pending messages, in order, and report the dropped
+	// ones, if any. Messages that may be preceded by messages being
+	// pushed are held back in _held till a later drain.
+	void drain();
+
+	void start_writer();
+	void stop_writer();
+	void writer_loop();
+
+	std::atomic<bool> _async;
+	std::atomic<size_t> _buffer_size;
+
+	// Order of the messages across threads
+	std::atomic<uint64_t> _sequence;
+
+	std::atomic<uint64_t> _dropped;
+	uint64_t _reported_dropped;
+
+	// Ring buffers of all threads that have logged
+	std::vector<std::shared_ptr<URELogRing>> _rings;
+	std::mutex _rings_mutex;
+
+	// Only one thread drains at a time
+	std::mutex _drain_mutex;
+
+	// Messages popped but not written yet, protected by _drain_mutex
+	std::vector<URELogEntry> _held;
+
+	std::thread _writer;
+	std::mutex _writer_mutex;
+	std::condition_variable _writer_cv;
+	bool _stop_writer;
+};
+
+// singleton instance (following Meyer's design pattern)
+URELogSink& ure_log_sink();
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_URE_LOG_SINK_H_
@@ -22,6 +22,7 @@
  */
 
 #include "URELogger.h"
+#include "URELogSink.h"
 
 using namespace opencog;
 
@@ -36,3 +37,19 @@ Logger& opencog::ure_logger()
 	static Logger ure_instance(ure_logger_instantiate());
 	return ure_instance;
 }
+
+URELogStream::~URELogStream()
+{
+	if (ure_log_sink().is_async())
+		ure_log_sink().log(_level, _ss.str());
+	else
+		ure_logger().log(_level, _ss.str());
+}
+
+std::ostream& opencog::operator<<(std::ostream& out,
+                                  const IterationPrefix& prefix)
+{
+	if (0 <= prefix.iteration)
+		out << "[I-" << prefix.iteration << "] ";
+	return out;
+}
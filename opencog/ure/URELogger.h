@@ -24,20 +24,93 @@
 #ifndef _OPENCOG_URELOGGER_H_
 #define _OPENCOG_URELOGGER_H_
 
+#include <ostream>
+#include <sstream>
+
 #include <opencog/util/Logger.h>
 
+// Minimum severity level of the URE log messages that are compiled
+// in. Messages of lower severity, that is more verbose, are compiled
+// out, regardless of the level of the logger at run time. For
+// instance, building with
+//
+// cmake -DURE_MIN_LOG_LEVEL=INFO
+//
+// compiles out all debug and fine messages of the hot loops.
+#ifndef URE_MIN_LOG_LEVEL
+#define URE_MIN_LOG_LEVEL FINE
+#endif
+
 namespace opencog
 {
 
 // singleton instance (following Meyer's design pattern)
 Logger& ure_logger();
 
-// Macros to not evaluate the stream if log level is disabled
-#define LAZY_URE_LOG_ERROR if(ure_logger().is_error_enabled()) ure_logger().error()
-#define LAZY_URE_LOG_WARN if(ure_logger().is_warn_enabled()) ure_logger().warn()
-#define LAZY_URE_LOG_INFO if(ure_logger().is_info_enabled()) ure_logger().info()
-#define LAZY_URE_LOG_DEBUG if(ure_logger().is_debug_enabled()) ure_logger().debug()
-#define LAZY_URE_LOG_FINE if(ure_logger().is_fine_enabled()) ure_logger().fine()
+// Return true iff messages of that level are compiled in
+#define URE_LOG_COMPILED(level) \
+	(opencog::Logger::level <= opencog::Logger::URE_MIN_LOG_LEVEL)
+
+/**
+ * Stream of a URE log message. The message is passed, upon
+ * destruction, to the asynchronous sink if enabled (see URELogSink),
+ * or to ure_logger() otherwise.
+ */
+class URELogStream
+{
+public:
+	explicit URELogStream(Logger::Level level) : _level(level) {}
+	~URELogStream();
+
+	template<typename T>
+	URELogStream& operator<<(const T& x)
+	{
+		_ss << x;
+		return *this;
+	}
+
+	// For manipulators such as std::endl
+	URELogStream& operator<<(std::ostream& (*manip)(std::ostream&))
+	{
+		manip(_ss);
+		return *this;
+	}
+
+private:
+	Logger::Level _level;
+	std::ostringstream _ss;
+};
+
+// Macros to not evaluate the stream if log level is disabled. The
+// if-else form makes them safe to use as the body of an if statement
+// followed by an else.
+#define LAZY_URE_LOG_ERROR if(not (URE_LOG_COMPILED(ERROR) and ure_logger().is_error_enabled())) {} else opencog::URELogStream(opencog::Logger::ERROR)
+#define LAZY_URE_LOG_WARN if(not (URE_LOG_COMPILED(WARN) and ure_logger().is_warn_enabled())) {} else opencog::URELogStream(opencog::Logger::WARN)
+#define LAZY_URE_LOG_INFO if(not (URE_LOG_COMPILED(INFO) and ure_logger().is_info_enabled())) {} else opencog::URELogStream(opencog::Logger::INFO)
+#define LAZY_URE_LOG_DEBUG if(not (URE_LOG_COMPILED(DEBUG) and ure_logger().is_debug_enabled())) {} else opencog::URELogStream(opencog::Logger::DEBUG)
+#define LAZY_URE_LOG_FINE if(not (URE_LOG_COMPILED(FINE) and ure_logger().is_fine_enabled())) {} else opencog::URELogStream(opencog::Logger::FINE)
+
+// Like Logger::is_<level>_enabled, but false if that level is
+// compiled out, to guard the construction of log messages.
+#define URE_LOG_DEBUG_ENABLED \
+	(URE_LOG_COMPILED(DEBUG) and ure_logger().is_debug_enabled())
+#define URE_LOG_FINE_ENABLED \
+	(URE_LOG_COMPILED(FINE) and ure_logger().is_fine_enabled())
+
+/**
+ * Prefix of the log messages of an iteration, "[I-<iteration>] ",
+ * only formatted when streamed, that is when the message is actually
+ * logged. The default one is empty.
+ */
+struct IterationPrefix
+{
+	explicit IterationPrefix(int iteration=-1) : iteration(iteration) {}
+
+	// Iteration number, starting at 1, negative if undefined
+	int iteration;
+};
+
+std::ostream& operator<<(std::ostream& out, const IterationPrefix& prefix);
 
 } // ~namespace opencog
 
@@ -0,0 +1,72 @@
+/*
+ * UREProbes.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_URE_PROBES_H_
+#define _OPENCOG_URE_PROBES_H_
+
+/**
+ * USDT (User Statically-Defined Tracing) probes of the URE, under the
+ * provider ure, to trace a live process, with bpftrace or perf,
+ * without rebuilding or enabling debug logging. For instance
+ *
+ * bpftrace -e 'usdt:/usr/local/lib/opencog/libure.so:ure:fc_apply_rule_end
+ *              { @products[str(arg0)] = sum(arg1); }' -p PID
+ *
+ * Available probes and their arguments are
+ *
+ * fc_iteration_start(int iteration)
+ * fc_iteration_end(int iteration, size_t products)
+ * fc_source_selected(uint64_t source_hash)
+ * fc_rule_selected(const char* rule_name)
+ * fc_apply_rule_start(const char* rule_name)
+ * fc_apply_rule_end(const char* rule_name, size_t products)
+ * bc_iteration_start(int iteration)
+ * bc_iteration_end(int iteration, size_t bit_size)
+ * bc_andbit_inserted(uint64_t fcs_hash, size_t bit_size)
+ * bc_andbit_erased(uint64_t fcs_hash, size_t bit_size)
+ * bc_fulfill_start(uint64_t fcs_hash)
+ * bc_fulfill_end(uint64_t fcs_hash, size_t results)
+ *
+ * A probe compiles to a single NOP, its arguments being only recorded
+ * in an ELF note, so arguments should be cheap to evaluate. Without
+ * sys/sdt.h (see HAVE_SYS_SDT_H) probes compile to nothing.
+ */
+
+#ifdef HAVE_SYS_SDT_H
+
+#include <sys/sdt.h>
+
+#define URE_PROBE(name) DTRACE_PROBE(ure, name)
+#define URE_PROBE1(name, a1) DTRACE_PROBE1(ure, name, a1)
+#define URE_PROBE2(name, a1, a2) DTRACE_PROBE2(ure, name, a1, a2)
+
+#else
+
+// Arguments are not evaluated, only referenced to avoid unused
+// variable warnings
+#define URE_PROBE(name) do {} while (0)
+#define URE_PROBE1(name, a1) do { (void)sizeof(a1); } while (0)
+#define URE_PROBE2(name, a1, a2) \
+	do { (void)sizeof(a1); (void)sizeof(a2); } while (0)
+
+#endif // HAVE_SYS_SDT_H
+
+#endif // _OPENCOG_URE_PROBES_H_
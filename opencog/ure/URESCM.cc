@@ -23,7 +23,13 @@
 
 #ifdef HAVE_GUILE
 
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+
 #include <opencog/ure/URELogger.h>
+#include <opencog/ure/URELogSink.h>
+#include <opencog/ure/TraceFile.h>
 #include <opencog/guile/SchemeModule.h>
 
 namespace opencog {
@@ -87,6 +93,52 @@ protected:
 	 */
 	Logger* do_ure_logger();
 
+	/**
+	 * Return the profiling counters of the last forward or backward
+	 * chainer run, as a JSON string (see ChainerStats::to_json). The
+	 * counters are only recorded if URE:collect-stats is true.
+	 */
+	std::string do_ure_stats();
+
+	/**
+	 * Return the number of wins of each backward chainer portfolio
+	 * member name, across all portfolios run so far, as a JSON
+	 * object, see BCPortfolio::get_win_counts.
+	 */
+	std::string do_ure_portfolio_win_counts();
+
+	/**
+	 * Configure the asynchronous sink of the URE logger, see
+	 * URELogSink.
+	 */
+	void do_ure_logger_set_async(bool async);
+	void do_ure_logger_set_async_buffer_size(int size);
+	int do_ure_logger_get_async_dropped();
+	void do_ure_logger_flush();
+
+	/**
+	 * Set the binary trace file of the subsequent chainer runs, see
+	 * set_ure_trace_file.
+	 */
+	void do_ure_set_trace_file(const std::string& filename, int sampling);
+
+	/**
+	 * Return the results of the forward chainer running, or last
+	 * run, via cog-fc, produced since the previous call. Meant to be
+	 * called from another thread to consume the results while cog-fc
+	 * is running.
+	 */
+	HandleSeq do_ure_fc_new_results();
+
+	// Results of the forward chainer running via cog-fc, not yet
+	// returned by do_ure_fc_new_results
+	HandleSeq _fc_new_results;
+	std::mutex _fc_new_results_mutex;
+
+	// Profiling counters of the last chainer run, in JSON format
+	std::string _last_stats;
+	std::mutex _last_stats_mutex;
+
 public:
 	URESCM();
 };
@@ -98,6 +150,7 @@ public:
 
 #include "forwardchainer/ForwardChainer.h"
 #include "backwardchainer/BackwardChainer.h"
+#include "backwardchainer/BCPortfolio.h"
 #include "UREConfig.h"
 
 using namespace opencog;
@@ -116,6 +169,30 @@ void URESCM::init(void)
 
 	define_scheme_primitive("cog-ure-logger",
 		&URESCM::do_ure_logger, this, "ure");
+
+	define_scheme_primitive("cog-ure-stats",
+		&URESCM::do_ure_stats, this, "ure");
+
+	define_scheme_primitive("cog-ure-portfolio-win-counts",
+		&URESCM::do_ure_portfolio_win_counts, this, "ure");
+
+	define_scheme_primitive("cog-ure-logger-set-async!",
+		&URESCM::do_ure_logger_set_async, this, "ure");
+
+	define_scheme_primitive("cog-ure-logger-set-async-buffer-size!",
+		&URESCM::do_ure_logger_set_async_buffer_size, this, "ure");
+
+	define_scheme_primitive("cog-ure-logger-get-async-dropped",
+		&URESCM::do_ure_logger_get_async_dropped, this, "ure");
+
+	define_scheme_primitive("cog-ure-logger-flush",
+		&URESCM::do_ure_logger_flush, this, "ure");
+
+	define_scheme_primitive("cog-ure-set-trace-file!",
+		&URESCM::do_ure_set_trace_file, this, "ure");
+
+	define_scheme_primitive("cog-ure-fc-new-results",
+		&URESCM::do_ure_fc_new_results, this, "ure");
 }
 
 Handle URESCM::do_forward_chaining(Handle rbs,
@@ -143,7 +220,19 @@ Handle URESCM::do_forward_chaining(Handle rbs,
 			"URESCM::do_forward_chaining - focus set should be SET_LINK type!");
 
 	ForwardChainer fc(*asp.get(), rbs, source, vardecl, trace_as, focus_set);
+	{
+		std::lock_guard<std::mutex> lock(_fc_new_results_mutex);
+		_fc_new_results.clear();
+	}
+	fc.set_result_callback([this](const Handle& result) {
+			std::lock_guard<std::mutex> lock(_fc_new_results_mutex);
+			_fc_new_results.push_back(result);
+		});
 	fc.do_chain();
+	{
+		std::lock_guard<std::mutex> lock(_last_stats_mutex);
+		_last_stats = fc.get_stats().to_json();
+	}
 	return fc.get_results();
 }
 
@@ -170,6 +259,10 @@ Handle URESCM::do_backward_chaining(Handle rbs,
 	BackwardChainer bc(*asp.get(), rbs, target, vardecl, trace_as, control_as, focus_link);
 
 	bc.do_chain();
+	{
+		std::lock_guard<std::mutex> lock(_last_stats_mutex);
+		_last_stats = bc.get_stats().to_json();
+	}
 
 	return bc.get_results();
 }
@@ -179,6 +272,58 @@ Logger* URESCM::do_ure_logger()
 	return &ure_logger();
 }
 
+std::string URESCM::do_ure_stats()
+{
+	std::lock_guard<std::mutex> lock(_last_stats_mutex);
+	return _last_stats;
+}
+
+std::string URESCM::do_ure_portfolio_win_counts()
+{
+	std::stringstream ss;
+	ss << "{";
+	bool first = true;
+	for (const auto& nc : BCPortfolio::get_win_counts()) {
+		ss << (first ? "" : ", ") << "\"" << nc.first << "\": " << nc.second;
+		first = false;
+	}
+	ss << "}";
+	return ss.str();
+}
+
+void URESCM::do_ure_logger_set_async(bool async)
+{
+	ure_log_sink().set_async(async);
+}
+
+void URESCM::do_ure_logger_set_async_buffer_size(int size)
+{
+	ure_log_sink().set_buffer_size(std::max(1, size));
+}
+
+int URESCM::do_ure_logger_get_async_dropped()
+{
+	return ure_log_sink().get_dropped_count();
+}
+
+void URESCM::do_ure_logger_flush()
+{
+	ure_log_sink().flush();
+}
+
+HandleSeq URESCM::do_ure_fc_new_results()
+{
+	std::lock_guard<std::mutex> lock(_fc_new_results_mutex);
+	HandleSeq results;
+	std::swap(results, _fc_new_results);
+	return results;
+}
+
+void URESCM::do_ure_set_trace_file(const std::string& filename, int sampling)
+{
+	set_ure_trace_file(filename, std::max(1, sampling));
+}
+
 extern "C" {
 void opencog_ure_init(void);
 };
@@ -19,6 +19,20 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <limits>
+#include <sstream>
+
+#include <boost/algorithm/cxx11/any_of.hpp>
+
+#include <opencog/util/algorithm.h>
+#include <opencog/util/oc_assert.h>
+#include <opencog/atoms/base/Node.h>
+#include <opencog/atoms/core/FindUtils.h>
+#include <opencog/atoms/core/LambdaLink.h>
+#include <opencog/atoms/core/VariableSet.h>
+#include <opencog/atoms/core/Variables.h>
+#include <opencog/unify/Unify.h>
+
 #include "Utils.h"
 
 namespace opencog {
@@ -44,4 +58,88 @@ bool remove_hypergraph(AtomSpace& as, const Handle& h)
 	}
 }
 
+/// Return false if general cannot possibly match specific, given
+/// the variables of general. Unordered links are not inspected, they
+/// are left to Unify.
+static bool may_subsume(const Handle& general, const Handle& specific,
+                        const HandleSet& vars)
+{
+	if (contains(vars, general))
+		return true;
+	if (general->get_type() != specific->get_type())
+		return false;
+	if (general->is_node())
+		return general == specific;
+	if (general->get_arity() != specific->get_arity())
+		return false;
+	if (nameserver().isA(general->get_type(), UNORDERED_LINK))
+		return true;
+	for (Arity i = 0; i < general->get_arity(); i++)
+		if (not may_subsume(general->getOutgoingAtom(i),
+		                    specific->getOutgoingAtom(i), vars))
+			return false;
+	return true;
+}
+
+bool subsumes(const Handle& general, const Handle& specific,
+              const Handle& general_vardecl)
+{
+	const static Handle empty_variable_set =
+		Handle(createVariableSet(HandleSeq()));
+
+	HandleSet vars = general_vardecl ?
+		Variables(general_vardecl).varset : get_free_variables(general);
+	if (not may_subsume(general, specific, vars))
+		return false;
+
+	// Variables of specific are constants, thus must not be confused
+	// with the variables of general of the same name.
+	Handle gen = general;
+	Handle gen_vardecl = general_vardecl ? general_vardecl
+		: Handle(createVariableSet(HandleSeq(vars.begin(), vars.end())));
+	HandleSet spe_vars = get_free_variables(specific);
+	if (boost::algorithm::any_of(vars, [&](const Handle& var) {
+				return contains(spe_vars, var); })) {
+		Handle lambda = createLambdaLink(gen_vardecl, gen);
+		ScopeLinkPtr fresh = ScopeLinkCast(rand_alpha_converted(lambda));
+		gen = fresh->get_body();
+		gen_vardecl = fresh->get_vardecl();
+	}
+
+	Unify unify(gen, specific, gen_vardecl, empty_variable_set);
+	return unify().is_satisfiable();
+}
+
+static thread_local RandGen* _thread_rand_gen = nullptr;
+
+RandGen& ure_rand_gen()
+{
+	return _thread_rand_gen ? *_thread_rand_gen : randGen();
+}
+
+Handle rand_alpha_converted(const Handle& scope)
+{
+	ScopeLinkPtr sc = ScopeLinkCast(scope);
+	OC_ASSERT(sc != nullptr, "Expect a scope link");
+
+	HandleSeq fresh_vars;
+	for (const Handle& var : sc->get_variables().varseq) {
+		std::stringstream ss;
+		ss << var->get_name() << "-" << std::hex
+		   << ure_rand_gen().randint(std::numeric_limits<int>::max());
+		fresh_vars.push_back(createNode(var->get_type(), ss.str()));
+	}
+	return sc->alpha_convert(fresh_vars);
+}
+
+ScopedRandGen::ScopedRandGen(RandGen& rng) : _previous(_thread_rand_gen)
+{
+	_thread_rand_gen = &rng;
+}
+
+ScopedRandGen::~ScopedRandGen()
+{
+	_thread_rand_gen = _previous;
+}
+
 } // ~namespace opencog
@@ -22,6 +22,11 @@
 #ifndef _OPENCOG_URE_UTILS_H
 #define _OPENCOG_URE_UTILS_H
 
+#include <atomic>
+#include <future>
+#include <vector>
+
+#include <opencog/util/RandGen.h>
 #include <opencog/atomspace/AtomSpace.h>
 #include <opencog/atoms/base/Handle.h>
 
@@ -49,6 +54,100 @@ namespace opencog
  */
 bool remove_hypergraph(AtomSpace&, const Handle&);
 
+/**
+ * Return true iff specific is an instance of general, that is if
+ * some substitution of the variables of general turns it into
+ * specific. The variables of specific, if any, are regarded as
+ * constants, so the matching is one-way.
+ *
+ * A cheap structural test is first carried out to quickly discard
+ * terms that cannot match, only the remaining ones are passed to
+ * Unify.
+ *
+ * @param general         The term that may subsume specific
+ *
+ * @param specific        The term that may be subsumed by general
+ *
+ * @param general_vardecl The variable declaration of general. If
+ *                        undefined, then all free variables of general
+ *                        are considered.
+ *
+ * Example: subsumes(general, specific, vardecl) with
+ *
+ * general = InheritanceLink
+ *             VariableNode "$X"
+ *             ConceptNode "frog"
+ * specific = InheritanceLink
+ *              ConceptNode "Fritz"
+ *              ConceptNode "frog"
+ * vardecl = VariableNode "$X"
+ *
+ * returns true, while swapping general and specific returns false.
+ */
+bool subsumes(const Handle& general, const Handle& specific,
+              const Handle& general_vardecl=Handle::UNDEFINED);
+
+/**
+ * Run f(0), ..., f(n-1) each in its own thread and wait till they
+ * have all completed. If f throws, the exception is rethrown in the
+ * calling thread (after all threads have completed).
+ *
+ * If jobs is positive and lower than n, then only that many threads
+ * are launched, each running the next f(i) not yet taken till there
+ * are none left. In that case, a thread stops at its first exception.
+ */
+template<typename Function>
+void run_concurrently(size_t n, const Function& f, size_t jobs=0)
+{
+	if (jobs == 0 or n < jobs)
+		jobs = n;
+	std::atomic<size_t> next(0);
+	auto worker = [&]() {
+		for (size_t i = next++; i < n; i = next++)
+			f(i);
+	};
+	std::vector<std::future<void>> futures;
+	for (size_t j = 0; j < jobs; j++)
+		futures.push_back(std::async(std::launch::async, worker));
+	for (auto& fut : futures)
+		fut.wait();
+	for (auto& fut : futures)
+		fut.get();
+}
+
+/**
+ * Return the random generator used by the chainers in the calling
+ * thread. That is the global one, randGen(), unless a thread specific
+ * one has been installed with ScopedRandGen.
+ *
+ * This allows to run several chainers concurrently, each with its own
+ * generator, and thus deterministically given their seeds.
+ */
+RandGen& ure_rand_gen();
+
+/**
+ * Return a copy of the given scope link with its variables renamed
+ * after fresh names, drawn from ure_rand_gen() rather than the
+ * global random generator, as ScopeLink::alpha_convert() does, so
+ * that it can be called concurrently from threads with their own
+ * generators.
+ */
+Handle rand_alpha_converted(const Handle& scope);
+
+/**
+ * Install a random generator for the calling thread, for the lifetime
+ * of this object, see ure_rand_gen.
+ */
+class ScopedRandGen
+{
+public:
+	ScopedRandGen(RandGen& rng);
+	~ScopedRandGen();
+
+private:
+	RandGen* _previous;
+};
+
 } // ~namespace opencog
 
 #endif // _OPENCOG_URE_UTILS_H
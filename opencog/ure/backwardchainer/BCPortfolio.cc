@@ -0,0 +1,128 @@
+/*
+ * BCPortfolio.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <opencog/util/mt19937ar.h>
+
+#include "BCPortfolio.h"
+#include "../URELogger.h"
+
+using namespace opencog;
+
+std::map<std::string, unsigned> BCPortfolio::_win_counts;
+std::mutex BCPortfolio::_win_counts_mutex;
+
+BCPortfolio::BCPortfolio(AtomSpace& kb_as,
+                         AtomSpace& rb_as,
+                         const Handle& rbs,
+                         const Handle& target,
+                         const Handle& vardecl,
+                         const std::vector<BCPortfolioMember>& members,
+                         double min_confidence)
+	: _kb_as(kb_as), _members(members),
+	  _min_confidence(min_confidence), _winner(-1)
+{
+	// Each backward chainer has its own BIT atomspace, child of kb_as
+	for (size_t i = 0; i < _members.size(); i++) {
+		_bcs.emplace_back(new BackwardChainer(kb_as, rb_as, rbs,
+		                                      target, vardecl));
+		if (_members[i].configure)
+			_members[i].configure(_bcs.back()->get_config());
+		_bcs.back()->set_result_callback([this, i](const Handle& result) {
+				if (is_winning_result(result))
+					win(i);
+			});
+	}
+}
+
+void BCPortfolio::do_chain()
+{
+	LAZY_URE_LOG_DEBUG << "Start portfolio of " << _members.size()
+	                   << " backward chainers";
+
+	// Winning results are detected by the result callbacks of the
+	// members, which then cancel all of them.
+	run_concurrently(_bcs.size(), [this](size_t i) {
+			MT19937RandGen rng(_members[i].seed);
+			ScopedRandGen scoped_rng(rng);
+			_bcs[i]->do_chain();
+		});
+
+	// Collect the results
+	if (0 <= _winner) {
+		_results = _bcs[_winner]->copy_results();
+	} else {
+		for (const auto& bc : _bcs) {
+			HandleSet results = bc->copy_results();
+			_results.insert(results.begin(), results.end());
+		}
+	}
+
+	LAZY_URE_LOG_DEBUG << "Finished portfolio, winner: "
+	                   << (0 <= _winner ? _members[_winner].name : "none");
+}
+
+Handle BCPortfolio::get_results() const
+{
+	HandleSeq results(_results.begin(), _results.end());
+	return _kb_as.add_link(SET_LINK, std::move(results));
+}
+
+const HandleSet& BCPortfolio::get_results_set() const
+{
+	return _results;
+}
+
+int BCPortfolio::get_winner() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _winner;
+}
+
+std::map<std::string, unsigned> BCPortfolio::get_win_counts()
+{
+	std::lock_guard<std::mutex> lock(_win_counts_mutex);
+	return _win_counts;
+}
+
+bool BCPortfolio::is_winning_result(const Handle& result) const
+{
+	return _min_confidence <= result->getTruthValue()->get_confidence();
+}
+
+void BCPortfolio::win(size_t i)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (0 <= _winner)
+			return;
+		_winner = i;
+	}
+	{
+		std::lock_guard<std::mutex> lock(_win_counts_mutex);
+		_win_counts[_members[i].name]++;
+	}
+	LAZY_URE_LOG_DEBUG << "Portfolio member " << _members[i].name
+	                   << " has won, cancel all members";
+
+	// The winner is cancelled as well since it has already produced
+	// a satisfying result.
+	for (auto& bc : _bcs)
+		bc->cancel();
+}
@@ -0,0 +1,134 @@
+/*
+ * BCPortfolio.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_BCPORTFOLIO_H_
+#define _OPENCOG_BCPORTFOLIO_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "BackwardChainer.h"
+
+namespace opencog
+{
+
+/**
+ * Configuration of a member of a portfolio, see BCPortfolio.
+ */
+struct BCPortfolioMember
+{
+	// Name of the configuration, used to record wins
+	std::string name;
+
+	// Modify the configuration of the member, loaded from the
+	// rule-base, for instance its complexity penalty, maximum BIT
+	// size or mixture model parameters. Can be empty.
+	std::function<void(UREConfig&)> configure;
+
+	// Seed of the random generator of the member
+	unsigned long seed;
+};
+
+/**
+ * Race differently configured backward chainers on the same target.
+ *
+ * Each member runs in its own thread, with its own random generator
+ * and BIT atomspace, over the shared knowledge-base. The first member
+ * to produce a result with a confidence greater than or equal to the
+ * minimum confidence wins, all members are then cancelled. If no
+ * member produces such a result, there is no winner and the results
+ * of all members are merged.
+ *
+ * Wins are counted per member name across portfolios, so that the
+ * configurations can be tuned.
+ */
+class BCPortfolio
+{
+public:
+	/**
+	 * CTor, see BackwardChainer for the description of the shared
+	 * arguments.
+	 */
+	BCPortfolio(AtomSpace& kb_as,
+	            AtomSpace& rb_as,
+	            const Handle& rbs,
+	            const Handle& target,
+	            const Handle& vardecl,
+	            const std::vector<BCPortfolioMember>& members,
+	            double min_confidence=0.0);
+
+	/**
+	 * Run the members till one wins or they all terminate.
+	 */
+	void do_chain();
+
+	/**
+	 * Return the results of the winner if any, otherwise the merged
+	 * results of all members, as a SetLink.
+	 */
+	Handle get_results() const;
+	const HandleSet& get_results_set() const;
+
+	/**
+	 * Return the index of the winning member, or -1 if none has won.
+	 */
+	int get_winner() const;
+
+	/**
+	 * Return the number of wins per member name, across all
+	 * portfolios. Available in scheme as cog-ure-portfolio-win-counts.
+	 */
+	static std::map<std::string, unsigned> get_win_counts();
+
+private:
+	// Return true iff the result has enough confidence
+	bool is_winning_result(const Handle& result) const;
+
+	// Record the win of member i
+	void win(size_t i);
+
+	AtomSpace& _kb_as;
+
+	std::vector<BCPortfolioMember> _members;
+
+	// Backward chainers of the members, same order as _members
+	std::vector<std::unique_ptr<BackwardChainer>> _bcs;
+
+	double _min_confidence;
+
+	// Index of the winning member, -1 if none
+	int _winner;
+
+	HandleSet _results;
+
+	// Protect _winner
+	mutable std::mutex _mutex;
+
+	static std::map<std::string, unsigned> _win_counts;
+	static std::mutex _win_counts_mutex;
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_BCPORTFOLIO_H_
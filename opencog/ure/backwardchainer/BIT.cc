@@ -140,9 +140,9 @@ AndBIT AndBIT::expand(const Handle& leaf,
 
 	// Discard expansion with cycle
 	if (has_cycle(BindLinkCast(new_fcs)->get_implicand()[0])) {
-		ure_logger().debug() << "The new FCS has some cycle (some conclusion "
-		                     << "has itself has premise, directly or "
-		                     << "indirectly). This expansion has been cancelled.";
+		LAZY_URE_LOG_DEBUG << "The new FCS has some cycle (some conclusion "
+		                   << "has itself has premise, directly or "
+		                   << "indirectly). This expansion has been cancelled.";
 		return AndBIT();
 	}
 
@@ -168,7 +168,7 @@ BITNode* AndBIT::select_leaf()
 
 	// If well defined then sample according to it
 	LeafDistribution dist(weights.begin(), weights.end());
-	return &rand_element(leaf2bitnode, dist).second;
+	return &std::next(leaf2bitnode.begin(), dist(ure_rand_gen()))->second;
 }
 
 void AndBIT::reset_exhausted()
@@ -792,7 +792,7 @@ std::string AndBIT::line_separator(const std::string& up_aa,
 // BIT //
 /////////
 
-BIT::BIT() : _as(nullptr) {}
+BIT::BIT() : _as(nullptr), _subsumption_pruning(false) {}
 
 BIT::BIT(AtomSpace& as,
          const Handle& target,
@@ -800,7 +800,7 @@ BIT::BIT(AtomSpace& as,
          const BITNodeFitness& fitness)
 	: bit_as(&as), // child atomspace of as
 	  _as(&as), _init_target(target), _init_vardecl(vardecl),
-	  _init_fitness(fitness)
+	  _init_fitness(fitness), _subsumption_pruning(false)
 {
 	bit_as.clear_copy_on_write();
 }
@@ -821,30 +821,41 @@ AndBIT* BIT::init()
 {
 	andbits.emplace_back(bit_as, _init_target,
 	                     _init_vardecl, _init_fitness, _as);
+	if (_subsumption_pruning)
+		index_subsumption(andbits.begin()->fcs);
 
 	LAZY_URE_LOG_DEBUG << "Initialize BIT with:" << std::endl
 	                   << andbits.begin()->to_string();
+	URE_PROBE2(bc_andbit_inserted, andbits.begin()->fcs->get_hash(),
+	           andbits.size());
 
 	return &*andbits.begin();
 }
 
 AndBIT* BIT::expand(AndBIT& andbit, BITNode& bitleaf,
                     const RuleTypedSubstitutionPair& rule, double prob)
+{
+	// Expand the and-BIT and insert it in the BIT, if the expansion
+	// was successful
+	AndBIT new_andbit = expand_andbit(andbit, bitleaf, rule, prob);
+	return (bool)new_andbit.fcs ? insert(new_andbit) : nullptr;
+}
+
+AndBIT BIT::expand_andbit(AndBIT& andbit, BITNode& bitleaf,
+                          const RuleTypedSubstitutionPair& rule, double prob)
 {
 	// Make sure that the rule is not already an or-child of bitleaf.
 	if (contains(bitleaf, rule)) {
-		ure_logger().debug() << "An equivalent rule has already expanded "
-		                     << "that BIT-node, abort expansion";
-		return nullptr;
+		LAZY_URE_LOG_DEBUG << "An equivalent rule has already expanded "
+		                   << "that BIT-node, abort expansion";
+		return AndBIT();
 	}
 
 	// Insert the rule as or-branch of this bitleaf
 	bitleaf.rules.insert(rule);
 
-	// Expand the and-BIT and insert it in the BIT, if the expansion
-	// was successful
-	AndBIT new_andbit = andbit.expand(bitleaf.body, rule, prob);
-	return (bool)new_andbit.fcs ? insert(new_andbit) : nullptr;
+	// Expand the and-BIT
+	return andbit.expand(bitleaf.body, rule, prob);
 }
 
 AndBIT* BIT::insert(AndBIT& andbit)
@@ -855,13 +866,91 @@ AndBIT* BIT::insert(AndBIT& andbit)
 		                   << andbit.fcs->id_to_string();
 		return nullptr;
 	}
+	if (_subsumption_pruning and is_subsumed(andbit)) {
+		LAZY_URE_LOG_DEBUG << "The following and-BIT is subsumed by the BIT: "
+		                   << andbit.fcs->id_to_string();
+		return nullptr;
+	}
 	// Insert while keeping the order
 	auto it = andbits.insert(boost::lower_bound(andbits, andbit), andbit);
+	URE_PROBE2(bc_andbit_inserted, it->fcs->get_hash(), andbits.size());
+	if (_subsumption_pruning)
+		index_subsumption(it->fcs);
 
 	// Return andbit pointer
 	return &*it;
 }
 
+bool BIT::is_subsumed(const AndBIT& andbit) const
+{
+	// Compare pattern and rewrite terms, under the variables of the
+	// more general fcs
+	auto pattern_rewrite = [](const Handle& fcs) {
+		BindLinkPtr fcs_bl(BindLinkCast(fcs));
+		return createLink(HandleSeq{fcs_bl->get_body(),
+		                            fcs_bl->get_implicand()[0]}, LIST_LINK);
+	};
+	Handle specific = pattern_rewrite(andbit.fcs);
+
+	// Only the and-BITs of the same key, or of the undefined key, may
+	// subsume andbit
+	const static SubsumptionKey undefined_key(NOTYPE, 0, NOTYPE, 0,
+	                                          Handle::UNDEFINED);
+	SubsumptionKey key = subsumption_key(andbit.fcs);
+	for (const SubsumptionKey& k : {key, undefined_key}) {
+		auto it = _subsumption_index.find(k);
+		if (it == _subsumption_index.end())
+			continue;
+		for (const Handle& fcs : it->second)
+			if (subsumes(pattern_rewrite(fcs), specific,
+			             BindLinkCast(fcs)->get_vardecl()))
+				return true;
+		if (key == undefined_key)
+			break;
+	}
+	return false;
+}
+
+void BIT::set_subsumption_pruning(bool sp)
+{
+	if (sp and not _subsumption_pruning)
+		for (const AndBIT& andbit : andbits)
+			index_subsumption(andbit.fcs);
+	else if (not sp)
+		_subsumption_index.clear();
+	_subsumption_pruning = sp;
+}
+
+BIT::SubsumptionKey BIT::subsumption_key(const Handle& fcs)
+{
+	BindLinkPtr fcs_bl(BindLinkCast(fcs));
+	const HandleSet& vars = fcs_bl->get_variables().varset;
+	Handle pattern = fcs_bl->get_body(),
+		rewrite = fcs_bl->get_implicand()[0],
+		schema = rewrite->get_type() == EXECUTION_OUTPUT_LINK ?
+		rewrite->getOutgoingAtom(0) : Handle::UNDEFINED;
+	if (contains(vars, pattern) or contains(vars, rewrite)
+	    or (schema and contains(vars, schema)))
+		return SubsumptionKey(NOTYPE, 0, NOTYPE, 0, Handle::UNDEFINED);
+	return SubsumptionKey(pattern->get_type(), pattern->get_arity(),
+	                      rewrite->get_type(), rewrite->get_arity(), schema);
+}
+
+void BIT::index_subsumption(const Handle& fcs)
+{
+	_subsumption_index[subsumption_key(fcs)].insert(fcs);
+}
+
+void BIT::unindex_subsumption(const Handle& fcs)
+{
+	auto it = _subsumption_index.find(subsumption_key(fcs));
+	if (it == _subsumption_index.end())
+		return;
+	it->second.erase(fcs);
+	if (it->second.empty())
+		_subsumption_index.erase(it);
+}
+
 void BIT::reset_exhausted_flags()
 {
 	for (AndBIT& andbit : andbits)
@@ -23,11 +23,15 @@
 #ifndef _OPENCOG_BIT_H
 #define _OPENCOG_BIT_H
 
+#include <map>
+#include <tuple>
+
 #include <boost/operators.hpp>
 
 #include <opencog/util/empty_string.h>
 #include <opencog/ure/Rule.h>
 #include <opencog/ure/Utils.h>
+#include <opencog/ure/UREProbes.h>
 #include <opencog/atoms/base/Handle.h>
 #include "Fitness.h"
 
@@ -251,6 +255,15 @@ public:
 	std::string fcs_to_ascii_art(const Handle& fcs) const;
 	std::string fcs_rewrite_to_ascii_art(const Handle& h) const;
 
+	/**
+	 * Return the present clauses, respectively virtual clauses, of an
+	 * FCS pattern body, as built by mk_pattern.
+	 */
+	static HandleSeq get_present_clauses(const Handle& pattern);
+	static HandleSeq get_present_clauses(const HandleSeq& clauses);
+	static HandleSeq get_virtual_clauses(const Handle& pattern);
+	static HandleSeq get_virtual_clauses(const HandleSeq& clauses);
+
 private:
 	// Weighted distribution over the targets leaves, defined
 	// according to their BIT-node fitnesses. The higher the fitness
@@ -363,11 +376,6 @@ private:
 	 */
 	static void remove_redundant(HandleSeq& hs);
 
-	static HandleSeq get_present_clauses(const Handle& pattern);
-	static HandleSeq get_present_clauses(const HandleSeq& clauses);
-	static HandleSeq get_virtual_clauses(const Handle& pattern);
-	static HandleSeq get_virtual_clauses(const HandleSeq& clauses);
-
 	/**
 	 * Merge horizontally 2 ascii art strings, avoiding collision. The
 	 * collision distance is specified in dst, in number of horizontal
@@ -480,6 +488,18 @@ public:
 	               const RuleTypedSubstitutionPair& rule,
 	               double prob=1.0);
 
+	/**
+	 * Like expand but return the new and-BIT instead of inserting it
+	 * in the BIT. If the expansion has failed the fcs of the returned
+	 * and-BIT is undefined.
+	 *
+	 * Since it does not modify the container of and-BITs, it may be
+	 * called concurrently over distinct and-BITs.
+	 */
+	AndBIT expand_andbit(AndBIT& andbit, BITNode& bitleaf,
+	                     const RuleTypedSubstitutionPair& rule,
+	                     double prob=1.0);
+
 	/**
 	 * Insert a new andbit in the BIT and return its pointer, nullptr
 	 * if not inserted (which may happen if an equivalent one is
@@ -488,6 +508,20 @@ public:
 	 */
 	AndBIT* insert(AndBIT& andbit);
 
+	/**
+	 * Return true iff the fcs of andbit is an instance of the fcs of
+	 * an and-BIT of the BIT, see subsumes in Utils.h. Only the
+	 * and-BITs with the same subsumption key are considered, thus
+	 * subsumption pruning must be enabled.
+	 */
+	bool is_subsumed(const AndBIT& andbit) const;
+
+	/**
+	 * If enabled, insert discards and-BITs subsumed by the and-BITs
+	 * already in the BIT, as their results are included in theirs.
+	 */
+	void set_subsumption_pruning(bool sp);
+
 	/**
 	 * Erase the given and-BIT from the BIT and remove its FCS from
 	 * bit_as.
@@ -518,11 +552,36 @@ private:
 	Handle _init_target;
 	Handle _init_vardecl;
 	BITNodeFitness _init_fitness;
+
+	bool _subsumption_pruning;
+
+	// Structural key shared by an fcs and all the fcs it subsumes,
+	// that is the types and arities of its pattern and rewrite
+	// terms, and the schema of its rewrite term if it is an
+	// ExecutionOutputLink. An fcs with a variable in place of any of
+	// them may subsume fcs of any key, and is given the undefined
+	// key, NOTYPE everywhere.
+	typedef std::tuple<Type, Arity, Type, Arity, Handle> SubsumptionKey;
+	static SubsumptionKey subsumption_key(const Handle& fcs);
+
+	// Add or remove the fcs of an and-BIT to or from
+	// _subsumption_index.
+	void index_subsumption(const Handle& fcs);
+	void unindex_subsumption(const Handle& fcs);
+
+	// The fcs of the and-BITs of the BIT by subsumption key, only
+	// maintained if subsumption pruning is enabled, so that
+	// is_subsumed only compares an and-BIT to the few ones that may
+	// subsume it.
+	std::map<SubsumptionKey, HandleSet> _subsumption_index;
 };
 
 template<typename It>
 BIT::AndBITs::iterator BIT::erase(It pos)
 {
+	URE_PROBE2(bc_andbit_erased, pos->fcs->get_hash(), andbits.size() - 1);
+	if (_subsumption_pruning)
+		unindex_subsumption(pos->fcs);
 	remove_hypergraph(bit_as, pos->fcs);
 	return andbits.erase(pos);
 }
@@ -23,12 +23,33 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+
+#include <boost/range/algorithm/min_element.hpp>
+#include <boost/range/algorithm/reverse.hpp>
+#include <boost/range/algorithm/sort.hpp>
+#include <boost/range/algorithm/stable_sort.hpp>
+#include <boost/range/algorithm_ext/erase.hpp>
+#include <boost/algorithm/cxx11/all_of.hpp>
+#include <boost/algorithm/cxx11/none_of.hpp>
+
 #include <opencog/util/random.h>
+#include <opencog/util/mt19937ar.h>
 
 #include <opencog/unify/Unify.h>
+#include <opencog/atoms/core/FindUtils.h>
+#include <opencog/atoms/core/TypeUtils.h>
+#include <opencog/atoms/core/VariableSet.h>
 
 #include "BackwardChainer.h"
+#include "TargetDecomposer.h"
+#include "../RuleDependencyGraph.h"
 #include "../URELogger.h"
+#include "../URELogSink.h"
+#include "../UREProbes.h"
 
 using namespace opencog;
 
@@ -43,20 +64,30 @@ BackwardChainer::BackwardChainer(AtomSpace& kb_as,
                                                           // support
                                                           // focus_set
                                  const BITNodeFitness& bitnode_fitness,
-                                 const AndBITFitness& andbit_fitness)
+                                 const AndBITFitness& andbit_fitness,
+                                 std::shared_ptr<ControlRuleIndex> control_index)
 	: _kb_as(kb_as),
 	  _rb_as(rb_as),
+	  _rbs(rbs),
+	  _target(target),
+	  _vardecl(vardecl),
+	  _control_as(control_as),
 	  _config(_rb_as, rbs),
 	  _bit(kb_as, target, vardecl, bitnode_fitness),
 	  _andbit_fitness(andbit_fitness),
-	  _trace_recorder(trace_as),
-	  _control(_config, _bit, target, control_as),
+	  _trace_recorder(trace_as, ure_trace_file()),
+	  _control(_config, _bit, _target, control_as, control_index),
 	  _rules(_control.rules),
 	  _iteration(0),
-	  _last_expansion_andbit(nullptr)
+	  _cost_bound(-std::numeric_limits<double>::infinity()),
+	  _last_expansion_andbit(nullptr),
+	  _joined(false),
+	  _cancelled(false)
 {
 	// Record the target in the trace atomspace
 	_trace_recorder.target(target);
+
+	_stats.set_enabled(_config.get_collect_stats());
 }
 
 BackwardChainer::BackwardChainer(AtomSpace& kb_as,
@@ -67,14 +98,25 @@ BackwardChainer::BackwardChainer(AtomSpace& kb_as,
                                  AtomSpace* control_as,
                                  const Handle& focus_set,
                                  const BITNodeFitness& bitnode_fitness,
-                                 const AndBITFitness& andbit_fitness)
+                                 const AndBITFitness& andbit_fitness,
+                                 std::shared_ptr<ControlRuleIndex> control_index)
 	: BackwardChainer(kb_as,
 	                  rbs->getAtomSpace() ? *rbs->getAtomSpace() : kb_as,
 	                  rbs, target, vardecl, trace_as, control_as,
-	                  focus_set, bitnode_fitness, andbit_fitness)
+	                  focus_set, bitnode_fitness, andbit_fitness,
+	                  control_index)
 {
 }
 
+BackwardChainer::~BackwardChainer()
+{
+	// Wait for the pending fulfillments, which may log, then write
+	// the pending log messages, if asynchronous
+	_fulfillment_queue.reset();
+	if (ure_log_sink().is_async())
+		ure_log_sink().flush();
+}
+
 UREConfig& BackwardChainer::get_config()
 {
 	return _config;
@@ -85,38 +127,266 @@ const UREConfig& BackwardChainer::get_config() const
 	return _config;
 }
 
+std::shared_ptr<ControlRuleIndex> BackwardChainer::get_control_rule_index() const
+{
+	return _control.get_control_rule_index();
+}
+
 void BackwardChainer::do_chain()
 {
-	ure_logger().debug("Start backward chaining");
-	LAZY_URE_LOG_DEBUG << "With rule set:" << std::endl << oc_to_string(_rules);
+	begin_chain();
 
 	while (not termination())
 	{
 		do_step();
 	}
 
+	end_chain();
+}
+
+void BackwardChainer::begin_chain()
+{
+	ure_logger().debug("Start backward chaining");
+	LAZY_URE_LOG_DEBUG << "With rule set:" << std::endl << oc_to_string(_rules);
+
+	// Start the fulfillment workers, if asynchronous
+	if (0 < _config.get_fulfillment_jobs())
+		_fulfillment_queue.reset(
+			new FulfillmentQueue(_config.get_fulfillment_jobs(),
+			                     _config.get_fulfillment_queue_size()));
+
+	// Discard the and-BITs subsumed by other and-BITs, if enabled
+	_bit.set_subsumption_pruning(_config.get_subsumption_pruning());
+
+	// The configuration may have been modified since construction
+	_stats.set_enabled(_config.get_collect_stats());
+
+	// Discard the rules that cannot be grounded in the knowledge-base
+	if (_config.get_rule_pruning())
+		prune_rules();
+
+	// Solve the sub-targets first, if enabled
+	if (_config.get_target_decomposition())
+		decompose_target();
+}
+
+void BackwardChainer::end_chain()
+{
+	// Fulfill the remaining batch, if any
+	flush_fulfillment_batch();
+
+	// Wait for the pending fulfillments and stop the workers
+	if (_fulfillment_queue) {
+		_fulfillment_queue->wait();
+		_fulfillment_queue.reset();
+	}
+
 	LAZY_URE_LOG_DEBUG << "Finished backward chaining with results:"
 	                   << std::endl << oc_to_string(get_results_set());
 }
 
+void BackwardChainer::prune_rules()
+{
+	size_t rules_size = _rules.size();
+	_rules = RuleDependencyGraph(_rules).grounded_rules(_kb_as);
+	LAZY_URE_LOG_DEBUG << "Rule pruning has kept " << _rules.size()
+	                   << "/" << rules_size << " rules";
+}
+
+void BackwardChainer::decompose_target()
+{
+	if (_target->get_type() != AND_LINK or _target->get_arity() < 2)
+		return;
+
+	HandleSet varset = _vardecl ? Variables(_vardecl).varset
+		: get_free_variables(_target);
+	Handle vardecl = _vardecl ? _vardecl
+		: HandleCast(createVariableSet(HandleSeq(varset.begin(), varset.end())));
+	const HandleSeq& conjuncts = _target->getOutgoingSet();
+	ClausePlan plan = _clause_planner(_target, conjuncts, varset, _kb_as);
+
+	std::vector<HandleSeq> components;
+	for (const HandleSeq& comp : TargetDecomposer::components(conjuncts, varset))
+		components.push_back(TargetDecomposer::order(comp, plan, varset));
+
+	LAZY_URE_LOG_DEBUG << "Decompose target into " << components.size()
+	                   << " components:" << std::endl << oc_to_string(components);
+
+	// Temporary atomspace holding the sub-targets
+	AtomSpacePtr tmp_as(createAtomSpace(&_kb_as));
+	tmp_as->clear_copy_on_write();
+
+	int msi = _config.get_maximum_subtarget_instances();
+	size_t max_instances = msi < 0 ? std::numeric_limits<size_t>::max() : msi;
+
+	// Solve the components in lockstep, conjunct after conjunct, each
+	// conjunct being instantiated by the groundings of the prefix
+	// solved so far.
+	std::vector<bool> failed(components.size(), false);
+	for (size_t k = 0; ; k++) {
+		HandleSeq subtargets;
+		for (size_t i = 0; i < components.size(); i++) {
+			const HandleSeq& comp = components[i];
+			if (failed[i] or comp.size() <= k)
+				continue;
+			HandleSeq prefix(comp.begin(), comp.begin() + k);
+			HandleSeq instances = TargetDecomposer::instantiate(
+				comp[k], prefix, vardecl, *tmp_as, max_instances);
+			if (instances.empty())
+				failed[i] = true;
+			subtargets.insert(subtargets.end(),
+			                  instances.begin(), instances.end());
+		}
+		if (subtargets.empty())
+			break;
+		solve_subtargets(subtargets);
+	}
+
+	join_subtargets();
+}
+
+void BackwardChainer::join_subtargets()
+{
+	// The results of the sub-chainers are in the knowledge-base, thus
+	// fulfilling the initial and-BIT, that is the target itself,
+	// joins them.
+	if (not _bit.empty())
+		return;
+	_last_expansion_andbit = _bit.init();
+	_trace_recorder.andbit(*_last_expansion_andbit);
+	fulfill_fcs(_last_expansion_andbit->fcs);
+
+	std::lock_guard<std::mutex> lock(_results_mutex);
+	_joined = not _results.empty();
+	LAZY_URE_LOG_DEBUG << "Joining the results of the sub-targets has produced "
+	                   << _results.size() << " results";
+}
+
+void BackwardChainer::solve_subtargets(const HandleSeq& subtargets)
+{
+	LAZY_URE_LOG_DEBUG << "Solve sub-targets:" << std::endl
+	                   << oc_to_string(subtargets);
+
+	// The sub-chainers and their random generators are built
+	// sequentially, since the global random generator, used for
+	// seeding, is not thread safe.
+	std::vector<std::unique_ptr<BackwardChainer>> subbcs;
+	std::vector<std::unique_ptr<MT19937RandGen>> rngs;
+	for (const Handle& subtarget : subtargets) {
+		Handle subvardecl = _vardecl ? filter_vardecl(_vardecl, subtarget)
+			: Handle::UNDEFINED;
+		subbcs.emplace_back(new BackwardChainer(_kb_as, _rb_as, _rbs,
+		                                        subtarget, subvardecl,
+		                                        nullptr, _control_as,
+		                                        Handle::UNDEFINED,
+		                                        BITNodeFitness(),
+		                                        AndBITFitness(),
+		                                        get_control_rule_index()));
+		subbcs.back()->get_config().set_parameters(_config);
+		subbcs.back()->get_config().set_target_decomposition(false);
+		rngs.emplace_back(new MT19937RandGen(
+			ure_rand_gen().randint(std::numeric_limits<int>::max())));
+	}
+
+	run_concurrently(subbcs.size(), [&](size_t i) {
+			ScopedRandGen scoped_rng(*rngs[i]);
+			subbcs[i]->do_chain();
+		}, std::max(1, _config.get_jobs()));
+
+	for (size_t i = 0; i < subbcs.size(); i++)
+		LAZY_URE_LOG_DEBUG << "Sub-target:" << std::endl
+		                   << oc_to_string(subtargets[i])
+		                   << "has results:" << std::endl
+		                   << oc_to_string(subbcs[i]->get_results_set());
+}
+
 void BackwardChainer::do_step()
+{
+	int iteration = _iteration;
+	URE_PROBE1(bc_iteration_start, iteration);
+
+	// The BIT must be initialized before being expanded in parallel
+	if (0 < _config.get_beam_width() and not _bit.empty())
+		do_step_beam();
+	else if (1 < _config.get_jobs() and not _bit.empty())
+		do_step_multithread();
+	else
+		do_step_singlethread();
+
+	_stats.record_population(_iteration, _bit.size());
+	URE_PROBE2(bc_iteration_end, iteration, _bit.size());
+}
+
+void BackwardChainer::do_step_singlethread()
 {
 	_iteration++;
 
-	ure_logger().debug() << "Iteration " << _iteration
-	                     << "/" << _config.get_maximum_iterations_str();
+	LAZY_URE_LOG_DEBUG << "Iteration " << _iteration
+	                   << "/" << _config.get_maximum_iterations_str();
 
 	expand_bit();
 	fulfill_bit();
 	reduce_bit();
 }
 
+void BackwardChainer::do_step_multithread()
+{
+	expand_meta_rules();
+
+	// Select as many distinct and-BITs as jobs, without exceeding the
+	// maximum number of iterations
+	size_t n = _config.get_jobs();
+	int max_iter = _config.get_maximum_iterations();
+	if (0 <= max_iter)
+		n = std::min(n, (size_t)std::max(1, max_iter - _iteration));
+	std::vector<AndBIT*> andbits = select_expansion_andbits(n);
+
+	// Each expansion counts as an iteration. Make sure there is
+	// progress even if no and-BIT could be selected.
+	int first_iteration = _iteration + 1;
+	_iteration += std::max((size_t)1, andbits.size());
+	LAZY_URE_LOG_DEBUG << "Iterations " << first_iteration
+	                   << "-" << _iteration
+	                   << "/" << _config.get_maximum_iterations_str();
+
+	_last_expansion_andbit = nullptr;
+	expand_bit(andbits);
+	reduce_bit();
+}
+
+void BackwardChainer::do_step_beam()
+{
+	expand_meta_rules();
+
+	// Select the expandable and-BITs of the beam, without exceeding
+	// the maximum number of iterations
+	std::vector<AndBIT*> andbits;
+	int max_iter = _config.get_maximum_iterations();
+	for (AndBIT& andbit : _bit.andbits) {
+		if (0 <= max_iter and max_iter <= _iteration + (int)andbits.size())
+			break;
+		if (0 < operator()(andbit))
+			andbits.push_back(&andbit);
+	}
+
+	int first_iteration = _iteration + 1;
+	_iteration += std::max((size_t)1, andbits.size());
+	LAZY_URE_LOG_DEBUG << "Beam generation, iterations " << first_iteration
+	                   << "-" << _iteration
+	                   << "/" << _config.get_maximum_iterations_str();
+
+	_last_expansion_andbit = nullptr;
+	expand_bit(andbits);
+	prune_beam();
+}
+
 bool BackwardChainer::termination()
 {
 	bool terminate = false;
 	std::string msg;            // Cause of the termination
 
-	if (_config.get_maximum_iterations() == _iteration) {
+	int max_iter = _config.get_maximum_iterations();
+	if (0 <= max_iter and max_iter <= _iteration) {
 		msg = "reached the maximum number of iterations";
 		terminate = true;
 	}
@@ -124,13 +394,35 @@ bool BackwardChainer::termination()
 		msg = "all AndBITS are exhausted";
 		terminate = true;
 	}
+	else if (is_answered()) {
+		msg = "enough results have reached the confidence threshold";
+		terminate = true;
+	}
+	else if (_joined) {
+		msg = "the results of the sub-targets have been joined";
+		terminate = true;
+	}
+	else if (_cancelled) {
+		msg = "cancelled";
+		terminate = true;
+	}
 
 	if (terminate)
-		ure_logger().debug() << "Terminate: " << msg;
+		LAZY_URE_LOG_DEBUG << "Terminate: " << msg;
 
 	return terminate;
 }
 
+void BackwardChainer::cancel()
+{
+	_cancelled = true;
+}
+
+int BackwardChainer::get_iteration() const
+{
+	return _iteration;
+}
+
 Handle BackwardChainer::get_results() const
 {
 	HandleSeq results(_results.begin(), _results.end());
@@ -142,8 +434,63 @@ const HandleSet& BackwardChainer::get_results_set() const
 	return _results;
 }
 
+HandleSet BackwardChainer::copy_results() const
+{
+	std::lock_guard<std::mutex> lock(_results_mutex);
+	return _results;
+}
+
+const ChainerStats& BackwardChainer::get_stats() const
+{
+	return _stats;
+}
+
+void BackwardChainer::set_result_callback(const ResultCallback& cb)
+{
+	_result_callback = cb;
+}
+
+HandlePairSeq BackwardChainer::get_leaves() const
+{
+	HandlePairSeq leaves;
+	HandleSet visited;
+	for (const AndBIT& andbit : _bit.andbits) {
+		Handle vardecl =
+			BindLinkCast(andbit.fcs)->get_variables().get_vardecl();
+		for (const auto& lb : andbit.leaf2bitnode)
+			if (visited.insert(lb.first).second)
+				leaves.emplace_back(lb.first, filter_vardecl(vardecl, lb.first));
+	}
+	return leaves;
+}
+
+size_t BackwardChainer::fulfill_andbits(const HandleSet& leaves)
+{
+	size_t count = 0;
+	for (const AndBIT& andbit : _bit.andbits) {
+		for (const auto& lb : andbit.leaf2bitnode) {
+			if (leaves.find(lb.first) != leaves.end()) {
+				schedule_fulfillment(andbit.fcs);
+				count++;
+				break;
+			}
+		}
+	}
+	return count;
+}
+
+bool BackwardChainer::is_answered() const
+{
+	if (_config.get_confidence_threshold() < 0)
+		return false;
+	std::lock_guard<std::mutex> lock(_results_mutex);
+	return (int)_confident_results.size() >= _config.get_result_count();
+}
+
 void BackwardChainer::expand_meta_rules()
 {
+	ChainerStats::Timer timer(_stats, ChainerStats::META_RULE_EXPANSION);
+
 	// This is kinda of hack before meta rules are fully supported by
 	// the Rule class.
 	size_t rules_size = _rules.size();
@@ -153,9 +500,9 @@ void BackwardChainer::expand_meta_rules()
 	// flags.
 	if (rules_size != _rules.size()) {
 		_bit.reset_exhausted_flags();
-		ure_logger().debug() << "The rule set has gone from "
-		                     << rules_size << " rules to " << _rules.size()
-		                     << ". All exhausted flags have been reset.";
+		LAZY_URE_LOG_DEBUG << "The rule set has gone from "
+		                   << rules_size << " rules to " << _rules.size()
+		                   << ". All exhausted flags have been reset.";
 	}
 }
 
@@ -182,14 +529,16 @@ void BackwardChainer::expand_bit()
 
 void BackwardChainer::expand_bit(AndBIT& andbit)
 {
+	ChainerStats::Timer timer(_stats, ChainerStats::BC_EXPANSION);
+
 	// Select leaf
 	BITNode* bitleaf = andbit.select_leaf();
 	if (bitleaf) {
 		LAZY_URE_LOG_DEBUG << "Selected BIT-node for expansion:" << std::endl
 		                   << bitleaf->to_string();
 	} else {
-		ure_logger().debug() << "All BIT-nodes of this and-BIT are exhausted "
-		                     << "(or possibly fulfilled). Abort expansion.";
+		LAZY_URE_LOG_DEBUG << "All BIT-nodes of this and-BIT are exhausted "
+		                   << "(or possibly fulfilled). Abort expansion.";
 		andbit.exhausted = true;
 		return;
 	}
@@ -200,21 +549,9 @@ void BackwardChainer::expand_bit(AndBIT& andbit)
 	Unify::TypedSubstitution ts(rule_sel.first.second);
 	double prob(rule_sel.second);
 
-	// Add the rule in the _bit.bit_as to make comparing atoms easier
-	// as well as logging more consistent.
-	rule.add(_bit.bit_as);
-
 	// Abort expansion if ill rule
-	if (not rule.is_valid()) {
-		ure_logger().debug("No valid rule for the selected BIT-node, "
-		                   "abort expansion");
-		return;
-	} else if (rule.has_cycle()) {
-		LAZY_URE_LOG_DEBUG << "The following rule has cycle (some premise "
-		                   << "equals to conclusion), abort expansion:"
-		                   << std::endl << rule.to_string();
+	if (not validate_rule(rule))
 		return;
-	}
 
 	// Rule seems well, expand
 	LAZY_URE_LOG_DEBUG << "Selected rule, with probability " << prob
@@ -237,6 +574,108 @@ void BackwardChainer::expand_bit(AndBIT& andbit)
 	}
 }
 
+void BackwardChainer::expand_bit(const std::vector<AndBIT*>& andbits)
+{
+	ChainerStats::Timer timer(_stats, ChainerStats::BC_EXPANSION);
+
+	// Select leaves sequentially, as it involves the random generator
+	std::vector<Expansion> expansions;
+	for (AndBIT* andbit : andbits) {
+		LAZY_URE_LOG_DEBUG << "Selected and-BIT for expansion:" << std::endl
+		                   << andbit->to_string();
+		BITNode* bitleaf = andbit->select_leaf();
+		if (not bitleaf) {
+			LAZY_URE_LOG_DEBUG << "All BIT-nodes of this and-BIT are exhausted "
+			                   << "(or possibly fulfilled). Abort expansion.";
+			andbit->exhausted = true;
+			continue;
+		}
+		Expansion expansion;
+		expansion.andbit = andbit;
+		expansion.bitleaf = bitleaf;
+		expansion.andbit_fcs = andbit->fcs;
+		expansion.bitleaf_body = bitleaf->body;
+		expansion.rng = std::make_shared<MT19937RandGen>(
+			ure_rand_gen().randint(std::numeric_limits<int>::max()));
+		expansions.push_back(expansion);
+	}
+
+	// Calculate the valid rules and their weights in parallel
+	size_t jobs = std::max(1, _config.get_jobs());
+	run_concurrently(expansions.size(), [&](size_t i) {
+			Expansion& ex = expansions[i];
+			ScopedRandGen scoped_rng(*ex.rng);
+			ex.candidates = _control.rule_candidates(*ex.andbit, *ex.bitleaf);
+		}, jobs);
+
+	// Select rules sequentially, as it involves the random generator
+	for (Expansion& ex : expansions)
+		ex.rule_sel = _control.select_rule(ex.candidates);
+
+	// Expand the and-BITs in parallel. The container of and-BITs is
+	// not modified till all threads have completed, so the and-BIT
+	// pointers remain valid meanwhile.
+	run_concurrently(expansions.size(), [&](size_t i) {
+			Expansion& ex = expansions[i];
+			ScopedRandGen scoped_rng(*ex.rng);
+			Rule& rule = ex.rule_sel.first.first;
+			if (not validate_rule(rule))
+				return;
+			RuleTypedSubstitutionPair rtsp{rule, ex.rule_sel.first.second};
+			ex.new_andbit = _bit.expand_andbit(*ex.andbit, *ex.bitleaf, rtsp,
+			                                   ex.rule_sel.second);
+		}, jobs);
+
+	// Insert the new and-BITs in the BIT and record the expansions in
+	// the trace atomspace, sequentially. And-BITs rejected by the
+	// BIT, as duplicates or subsumed, are not fulfilled.
+	HandleSeq inserted_fcss;
+	for (Expansion& ex : expansions) {
+		if (not ex.new_andbit.fcs)
+			continue;
+		const AndBIT* new_andbit = _bit.insert(ex.new_andbit);
+		if (new_andbit) {
+			_trace_recorder.andbit(*new_andbit);
+			_trace_recorder.expansion(ex.andbit_fcs, ex.bitleaf_body,
+			                          ex.rule_sel.first.first, *new_andbit);
+			inserted_fcss.push_back(new_andbit->fcs);
+		}
+	}
+
+	// Fulfill the inserted and-BITs, in parallel unless fulfillment
+	// is batched or asynchronous, in which case scheduling, which is
+	// not thread safe, is cheap anyway.
+	if (_fulfillment_queue or 1 < _config.get_fulfillment_batch_size()) {
+		for (const Handle& fcs : inserted_fcss)
+			schedule_fulfillment(fcs);
+	} else {
+		run_concurrently(inserted_fcss.size(), [&](size_t i) {
+				try {
+					fulfill_fcs(inserted_fcss[i]);
+				} catch (...) {}
+			}, jobs);
+	}
+}
+
+bool BackwardChainer::validate_rule(Rule& rule)
+{
+	// Add the rule in the _bit.bit_as to make comparing atoms easier
+	// as well as logging more consistent.
+	rule.add(_bit.bit_as);
+
+	if (not rule.is_valid()) {
+		ure_logger().debug("No valid rule for the selected BIT-node, "
+		                   "abort expansion");
+		return false;
+	} else if (rule.has_cycle()) {
+		LAZY_URE_LOG_DEBUG << "The following rule has cycle (some premise "
+		                   << "equals to conclusion), abort expansion:"
+		                   << std::endl << rule.to_string();
+		return false;
+	}
+	return true;
+}
+
 void BackwardChainer::fulfill_bit()
 {
 	if (_bit.empty()) {
@@ -247,22 +686,71 @@ void BackwardChainer::fulfill_bit()
 	// Select an and-BIT for fulfillment
 	const AndBIT* andbit = select_fulfillment_andbit();
 	if (andbit == nullptr) {
-		ure_logger().debug() << "Cannot fulfill an empty and-BIT. "
-		                    << "Abort BIT fulfillment";
+		LAZY_URE_LOG_DEBUG << "Cannot fulfill an empty and-BIT. "
+		                  << "Abort BIT fulfillment";
 		return;
 	}
 	LAZY_URE_LOG_DEBUG << "Selected and-BIT for fulfillment (fcs value):"
 	                   << std::endl << andbit->fcs->id_to_string();
 
+	schedule_fulfillment(andbit->fcs);
+}
+
+void BackwardChainer::schedule_fulfillment(const Handle& fcs)
+{
+	// Postpone fulfillment till the batch is full
+	int batch_size = _config.get_fulfillment_batch_size();
+	if (1 < batch_size) {
+		_fulfillment_batch.insert(fcs);
+		if ((int)_fulfillment_batch.size() >= batch_size)
+			flush_fulfillment_batch();
+		return;
+	}
+
 	// Wrap in a try/catch in case the pattern matcher can't handle
 	// it.
-	try {
-		fulfill_fcs(andbit->fcs);
-	} catch (...) {}
+	auto fulfill = [this, fcs]() {
+		try {
+			fulfill_fcs(fcs);
+		} catch (...) {}
+	};
+
+	// The job holds a copy of the FCS handle, which keeps it alive
+	// even if its and-BIT gets removed from the BIT by reduce_bit in
+	// the meantime.
+	if (_fulfillment_queue)
+		_fulfillment_queue->push(fulfill);
+	else
+		fulfill();
+}
+
+void BackwardChainer::flush_fulfillment_batch()
+{
+	for (const HandleSeq& group : _fulfillment_batch.pop_groups()) {
+		auto fulfill = [this, group]() {
+			try {
+				fulfill_fcs_group(group);
+			} catch (...) {}
+		};
+		if (_fulfillment_queue)
+			_fulfillment_queue->push(fulfill);
+		else
+			fulfill();
+	}
 }
 
 void BackwardChainer::fulfill_fcs(const Handle& fcs)
 {
+	// Pending fulfillments are pointless once answered or cancelled
+	if (is_answered() or _cancelled)
+		return;
+
+	if (is_unsatisfiable(fcs))
+		return;
+
+	ChainerStats::Timer timer(_stats, ChainerStats::FULFILLMENT);
+	URE_PROBE1(bc_fulfill_start, fcs->get_hash());
+
 	// Temporary atomspace to not pollute _as with intermediary
 	// results
 	AtomSpacePtr tmp_as(createAtomSpace(&_kb_as));
@@ -283,17 +771,92 @@ void BackwardChainer::fulfill_fcs(const Handle& fcs)
 	// TODO: Maybe we could take advantage of the new read-only
 	// capabilities of the AtomSpace.
 	Handle hresult = HandleCast(fcs->execute(tmp_as.get()));
+	add_results(fcs, hresult->getOutgoingSet());
+	URE_PROBE2(bc_fulfill_end, fcs->get_hash(), hresult->get_arity());
+}
+
+void BackwardChainer::fulfill_fcs_group(const HandleSeq& group)
+{
+	if (is_answered() or _cancelled)
+		return;
+
+	ChainerStats::Timer timer(_stats, ChainerStats::FULFILLMENT);
+
+	// Temporary atomspace to not pollute _as with intermediary
+	// results, see fulfill_fcs.
+	AtomSpacePtr tmp_as(createAtomSpace(&_kb_as));
+	tmp_as->clear_copy_on_write();
+
+	HandleSeq satisfiable_group;
+	for (const Handle& fcs : group) {
+		if (not is_unsatisfiable(fcs)) {
+			satisfiable_group.push_back(fcs);
+			URE_PROBE1(bc_fulfill_start, fcs->get_hash());
+		}
+	}
+
+	LAZY_URE_LOG_DEBUG << "Fulfill group of " << satisfiable_group.size()
+	                   << " FCSs";
+	FCSBatch::execute(satisfiable_group, *tmp_as,
+	                  [&](const Handle& fcs, const HandleSeq& results) {
+		                  add_results(fcs, results);
+		                  URE_PROBE2(bc_fulfill_end, fcs->get_hash(),
+		                             results.size());
+	                  });
+}
+
+void BackwardChainer::add_results(const Handle& fcs,
+                                  const HandleSeq& tmp_results)
+{
 	HandleSeq results;
-	for (const Handle& result : hresult->getOutgoingSet())
+	for (const Handle& result : tmp_results)
 		results.push_back(_kb_as.add_atom(result));
 	LAZY_URE_LOG_DEBUG << "Results:" << std::endl << results;
-	_results.insert(results.begin(), results.end());
+	{
+		std::lock_guard<std::mutex> lock(_results_mutex);
+		_results.insert(results.begin(), results.end());
+
+		// Keep track of the results reaching the confidence threshold
+		double threshold = _config.get_confidence_threshold();
+		if (0 <= threshold)
+			for (const Handle& result : results)
+				if (threshold <= result->getTruthValue()->get_confidence())
+					_confident_results.insert(result);
+	}
+
+	// Stream the results
+	if (_result_callback)
+		for (const Handle& result : results)
+			_result_callback(result);
 
 	// Record the results in _trace_as
 	for (const Handle& result : results)
 		_trace_recorder.proof(fcs, result);
 }
 
+ClausePlan BackwardChainer::plan_fcs(const Handle& fcs)
+{
+	BindLinkPtr fcs_bl(BindLinkCast(fcs));
+	Handle body = fcs_bl->get_body();
+	HandleSeq clauses = AndBIT::get_present_clauses(body);
+	HandleSeq virtual_clauses = AndBIT::get_virtual_clauses(body);
+	clauses.insert(clauses.end(), virtual_clauses.begin(), virtual_clauses.end());
+
+	return _clause_planner(fcs, clauses, fcs_bl->get_variables().varset, _kb_as);
+}
+
+bool BackwardChainer::is_unsatisfiable(const Handle& fcs)
+{
+	ClausePlan plan = plan_fcs(fcs);
+	if (plan.unsatisfiable()) {
+		LAZY_URE_LOG_DEBUG << "FCS cannot be satisfied, clause:" << std::endl
+		                   << oc_to_string(plan.clauses[0])
+		                   << "has no grounding, skip its fulfillment";
+		return true;
+	}
+	return false;
+}
+
 std::vector<double> BackwardChainer::expansion_andbit_weights()
 {
 	std::vector<double> weights;
@@ -304,22 +867,145 @@ std::vector<double> BackwardChainer::expansion_andbit_weights()
 
 AndBIT* BackwardChainer::select_expansion_andbit()
 {
+	if (is_deterministic()) {
+		std::vector<AndBIT*> best = select_best_andbits(1);
+		if (not best.empty())
+			return best.front();
+	}
+
 	std::vector<double> weights = expansion_andbit_weights();
 
 	// Debug log
-	if (ure_logger().is_debug_enabled()) {
+	if (URE_LOG_DEBUG_ENABLED) {
 		OC_ASSERT(weights.size() == _bit.andbits.size());
 		std::stringstream ss;
 		ss << "Weighted and-BITs:";
 		for (size_t i = 0; i < weights.size(); i++)
 			ss << std::endl << weights[i] << " "
 			   << _bit.andbits[i].fcs->id_to_string();
-		ure_logger().debug() << ss.str();
+		LAZY_URE_LOG_DEBUG << ss.str();
 	}
 
 	// Sample andbits according to this distribution
 	std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
-	return &rand_element(_bit.andbits, dist);
+	return &*std::next(_bit.andbits.begin(), dist(ure_rand_gen()));
+}
+
+std::vector<AndBIT*> BackwardChainer::select_expansion_andbits(size_t n)
+{
+	if (is_deterministic()) {
+		std::vector<AndBIT*> best = select_best_andbits(n);
+		if (not best.empty())
+			return best;
+	}
+
+	std::vector<double> weights = expansion_andbit_weights();
+	std::vector<AndBIT*> selected;
+	while (selected.size() < n) {
+		// Stop if no more and-BIT can be selected
+		if (boost::algorithm::all_of(weights, [](double w) { return w <= 0; }))
+			break;
+
+		// Sample an and-BIT and null its weight so that it doesn't
+		// get selected again
+		std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
+		size_t i = dist(ure_rand_gen());
+		selected.push_back(&_bit.andbits[i]);
+		weights[i] = 0.0;
+	}
+	return selected;
+}
+
+std::vector<AndBIT*> BackwardChainer::select_best_andbits(size_t n)
+{
+	// Only consider expandable and-BITs with finite costs
+	std::vector<double> costs = expansion_andbit_costs();
+	std::vector<size_t> candidates;
+	for (size_t i = 0; i < costs.size(); i++)
+		if (std::isfinite(costs[i]))
+			candidates.push_back(i);
+	if (candidates.empty())
+		return {};
+
+	if (_config.get_iterative_deepening()) {
+		// Raise the bound to the smallest cost if no and-BIT is within
+		if (boost::algorithm::none_of(candidates, [&](size_t i) {
+					return costs[i] <= _cost_bound; })) {
+			_cost_bound = costs[*boost::min_element(candidates,
+			                   [&](size_t i, size_t j) {
+				                   return costs[i] < costs[j]; })];
+			LAZY_URE_LOG_DEBUG << "Raise cost bound to " << _cost_bound;
+		}
+		boost::remove_erase_if(candidates, [&](size_t i) {
+				return _cost_bound < costs[i]; });
+
+		// Depth-first, since and-BITs are sorted by complexity the
+		// last ones are the deepest.
+		boost::reverse(candidates);
+	} else {
+		// Best-first, ties are broken by complexity, then content,
+		// which is the order of the and-BITs.
+		boost::stable_sort(candidates, [&](size_t i, size_t j) {
+				return costs[i] < costs[j]; });
+	}
+
+	// Debug log
+	if (URE_LOG_DEBUG_ENABLED) {
+		std::stringstream ss;
+		ss << "And-BITs by estimated cost:";
+		for (size_t i : candidates)
+			ss << std::endl << costs[i] << " "
+			   << _bit.andbits[i].fcs->id_to_string();
+		LAZY_URE_LOG_DEBUG << ss.str();
+	}
+
+	std::vector<AndBIT*> selected;
+	for (size_t i : candidates) {
+		if (n <= selected.size())
+			break;
+		selected.push_back(&_bit.andbits[i]);
+	}
+	return selected;
+}
+
+bool BackwardChainer::is_deterministic() const
+{
+	return _config.get_best_first() or _config.get_iterative_deepening();
+}
+
+std::vector<double> BackwardChainer::expansion_andbit_costs()
+{
+	std::vector<double> costs;
+	for (const AndBIT& andbit : _bit.andbits)
+		costs.push_back(estimated_cost(andbit));
+	return costs;
+}
+
+double BackwardChainer::estimated_cost(const AndBIT& andbit)
+{
+	if (operator()(andbit) <= 0)
+		return std::numeric_limits<double>::infinity();
+	return andbit.complexity + cost_heuristic(andbit);
+}
+
+double BackwardChainer::cost_heuristic(const AndBIT& andbit)
+{
+	ClausePlan plan = plan_fcs(andbit.fcs);
+	double h = 0.0;
+	for (size_t i = 0; i < plan.clauses.size(); i++) {
+		// Clauses are ordered by increasing estimates
+		if (0 < plan.estimates[i])
+			break;
+		auto it = andbit.leaf2bitnode.find(plan.clauses[i]);
+		if (it == andbit.leaf2bitnode.end()) {
+			h += 1;
+			continue;
+		}
+		if (it->second.exhausted)
+			return std::numeric_limits<double>::infinity();
+		h += 1 + it->second.complexity;
+	}
+	return h;
 }
 
 const AndBIT* BackwardChainer::select_fulfillment_andbit() const
@@ -329,6 +1015,8 @@ const AndBIT* BackwardChainer::select_fulfillment_andbit() const
 
 void BackwardChainer::reduce_bit()
 {
+	ChainerStats::Timer timer(_stats, ChainerStats::REDUCTION);
+
 	if (0 < _config.get_max_bit_size()) {
 		// If the BIT size has reached its maximum, randomly remove
 		// and-BITs so that the BIT size gets back below or equal to
@@ -338,11 +1026,40 @@ void BackwardChainer::reduce_bit()
 			// for the remaining of the inferenceThe and-BITs to remove are
 			// selected so that the least likely and-BITs to be
 			// selected for expansion are removed first.
-			remove_unlikely_expandable_andbit();
+			if (is_deterministic())
+				remove_most_costly_andbit();
+			else
+				remove_unlikely_expandable_andbit();
 		}
 	}
 }
 
+void BackwardChainer::prune_beam()
+{
+	ChainerStats::Timer timer(_stats, ChainerStats::REDUCTION);
+
+	size_t width = _config.get_beam_width();
+	if (_bit.size() <= width)
+		return;
+
+	std::vector<double> weights = expansion_andbit_weights();
+	std::vector<size_t> indices(weights.size());
+	std::iota(indices.begin(), indices.end(), 0);
+	boost::stable_sort(indices, [&](size_t i, size_t j) {
+			return weights[j] < weights[i]; });
+
+	// Remove the lightest and-BITs, from the last one so that the
+	// indices of the remaining ones stay valid.
+	std::vector<size_t> removed(indices.begin() + width, indices.end());
+	boost::sort(removed, std::greater<size_t>());
+	for (size_t i : removed) {
+		auto it = std::next(_bit.andbits.begin(), i);
+		LAZY_URE_LOG_DEBUG << "Remove " << it->fcs->id_to_string()
+		                   << " from the beam, with weight " << weights[i];
+		_bit.erase(it);
+	}
+}
+
 void BackwardChainer::remove_unlikely_expandable_andbit()
 {
 	std::vector<double> weights = expansion_andbit_weights();
@@ -363,14 +1080,14 @@ void BackwardChainer::remove_unlikely_expandable_andbit()
 	}
 
 	// Fine log
-	if (ure_logger().is_fine_enabled()) {
+	if (URE_LOG_FINE_ENABLED) {
 		OC_ASSERT(never_expand_probs.size() == _bit.andbits.size());
 		std::stringstream ss;
 		ss << "Never expand probs and-BITs:";
 		for (size_t i = 0; i < never_expand_probs.size(); i++)
 			ss << std::endl << never_expand_probs[i] << " "
 			   << _bit.andbits[i].fcs->id_to_string();
-		ure_logger().fine() << ss.str();
+		LAZY_URE_LOG_FINE << ss.str();
 	}
 
 	std::discrete_distribution<size_t>
@@ -378,12 +1095,29 @@ void BackwardChainer::remove_unlikely_expandable_andbit()
 
 	// Pick the and-BIT, remove it from the BIT and remove its
 	// FCS from the bit atomspace.
-	auto it = std::next(_bit.andbits.begin(), never_expand_dist(randGen()));
+	auto it = std::next(_bit.andbits.begin(), never_expand_dist(ure_rand_gen()));
 	LAZY_URE_LOG_DEBUG << "Remove " << it->fcs->id_to_string()
 	                   << " from the BIT";
 	_bit.erase(it);
 }
 
+void BackwardChainer::remove_most_costly_andbit()
+{
+	// Remove the last and-BIT with the highest cost, that is the most
+	// complex amongst them.
+	std::vector<double> costs = expansion_andbit_costs();
+	size_t worst = 0;
+	for (size_t i = 1; i < costs.size(); i++)
+		if (costs[worst] <= costs[i])
+			worst = i;
+
+	auto it = std::next(_bit.andbits.begin(), worst);
+	LAZY_URE_LOG_DEBUG << "Remove " << it->fcs->id_to_string()
+	                   << " from the BIT, with estimated cost "
+	                   << costs[worst];
+	_bit.erase(it);
+}
+
 double BackwardChainer::complexity_factor(const AndBIT& andbit) const
 {
 	return exp(-_config.get_complexity_penalty() * andbit.complexity);
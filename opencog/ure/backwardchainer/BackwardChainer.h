@@ -25,11 +25,22 @@
 #ifndef _OPENCOG_BACKWARDCHAINER_H_
 #define _OPENCOG_BACKWARDCHAINER_H_
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <opencog/util/mt19937ar.h>
+
 #include "../Rule.h"
 #include "../UREConfig.h"
+#include "../ChainerStats.h"
+#include "../ClausePlanner.h"
 #include "BIT.h"
 #include "TraceRecorder.h"
 #include "ControlPolicy.h"
+#include "FulfillmentQueue.h"
+#include "FCSBatch.h"
 
 class BackwardChainerUTest;
 
@@ -93,6 +104,9 @@ class BackwardChainer
 	friend class ::BackwardChainerUTest;
 
 public:
+	// Called on each new result, see set_result_callback
+	typedef std::function<void(const Handle&)> ResultCallback;
+
 	/**
 	 * CTor.
 	 *
@@ -106,6 +120,9 @@ public:
 	 * @param focus_set          Focus set (not implemented)
 	 * @param bitnode_fitness    BITNode fitness function
 	 * @param andbit_fitness     AndBIT (inference tree) fitness function
+	 * @param control_index      Index of the control rules of control_as,
+	 *                           built if not provided, see
+	 *                           get_control_rule_index
 	 */
 	BackwardChainer(AtomSpace& kb_as,
 	                AtomSpace& rb_as,
@@ -119,7 +136,8 @@ public:
 	                const Handle& focus_set=Handle::UNDEFINED,
 	                // TODO: maybe wrap all fitnesses in a Fitness class
 	                const BITNodeFitness& bitnode_fitness=BITNodeFitness(),
-	                const AndBITFitness& andbit_fitness=AndBITFitness());
+	                const AndBITFitness& andbit_fitness=AndBITFitness(),
+	                std::shared_ptr<ControlRuleIndex> control_index=nullptr);
 
 	/**
 	 * Like above, but use as rule-base atomspace, the atomspace of rbs
@@ -136,7 +154,10 @@ public:
 	                const Handle& focus_set=Handle::UNDEFINED,
 	                // TODO: maybe wrap all fitnesses in a Fitness class
 	                const BITNodeFitness& bitnode_fitness=BITNodeFitness(),
-	                const AndBITFitness& andbit_fitness=AndBITFitness());
+	                const AndBITFitness& andbit_fitness=AndBITFitness(),
+	                std::shared_ptr<ControlRuleIndex> control_index=nullptr);
+
+	~BackwardChainer();
 
 	/**
 	 * URE configuration accessors
@@ -144,14 +165,71 @@ public:
 	UREConfig& get_config();
 	const UREConfig& get_config() const;
 
+	/**
+	 * Return the index of the control rules of the control
+	 * atomspace, so that it can be shared with other backward
+	 * chainers using the same control atomspace. Return nullptr if
+	 * there is no control atomspace.
+	 */
+	std::shared_ptr<ControlRuleIndex> get_control_rule_index() const;
+
 	/**
 	 * Perform backward chaining inference till the termination
 	 * criteria have been met.
+	 *
+	 * If URE:BC:fulfillment-jobs is greater than 0, and-BITs are
+	 * fulfilled asynchronously by that many threads while the BIT
+	 * keeps being expanded. In that case do_chain only returns once
+	 * all pending fulfillments have completed.
+	 *
+	 * If URE:BC:fulfillment-batch-size is greater than 1, and-BITs
+	 * are fulfilled by batches of that size, grouped by common
+	 * clauses (see FCSBatch). The remaining batch is fulfilled before
+	 * do_chain returns.
+	 *
+	 * If URE:BC:target-decomposition is enabled and the target is
+	 * conjunctive, its conjuncts are first solved by sub-chainers,
+	 * then their results joined, see decompose_target. If the join
+	 * produces results, backward chaining stops there.
+	 *
+	 * If URE:BC:best-first or URE:BC:iterative-deepening is enabled,
+	 * and-BITs are selected for expansion deterministically, see
+	 * select_best_andbits.
+	 *
+	 * If URE:BC:rule-pruning is enabled, the rules that cannot be
+	 * grounded in the knowledge-base are discarded first, see
+	 * RuleDependencyGraph.
+	 *
+	 * If URE:BC:beam-width is positive, the BIT is expanded by beam
+	 * generations, see do_step_beam.
 	 */
 	void do_chain();
 
+	/**
+	 * Prepare and wrap up backward chaining, that is everything
+	 * do_chain does besides stepping till termination. Useful to
+	 * step the chainer manually, for instance alongside another
+	 * chainer, with
+	 *
+	 * begin_chain();
+	 * while (not termination()) do_step();
+	 * end_chain();
+	 *
+	 * begin_chain starts the fulfillment workers, if asynchronous,
+	 * prunes the rules and decomposes the target, if enabled.
+	 * end_chain fulfills the remaining batch and waits for the
+	 * pending fulfillments, so that all results are available once it
+	 * returns.
+	 */
+	void begin_chain();
+	void end_chain();
+
 	/**
 	 * Perform a single backward chaining inference step.
+	 *
+	 * If the number of jobs is greater than 1, then as many distinct
+	 * and-BITs are expanded and fulfilled in parallel (see
+	 * do_step_multithread), which counts as many iterations.
 	 */
 	void do_step();
 
@@ -160,10 +238,26 @@ public:
 	 *
 	 * More specifically, either
 	 * 1. reached the maximum number of iterations,
-	 * 2. or all andbits are exhausted.
+	 * 2. or all andbits are exhausted,
+	 * 3. or URE:BC:result-count results have reached
+	 *    URE:BC:confidence-threshold, if non-negative,
+	 * 4. or the results of the sub-targets of the target
+	 *    decomposition have been joined,
+	 * 5. or the chainer has been cancelled.
 	 */
 	bool termination();
 
+	/**
+	 * @return the number of iterations performed so far.
+	 */
+	int get_iteration() const;
+
+	/**
+	 * Cancel the chainer, so that it terminates at the end of the
+	 * current step. Thread safe.
+	 */
+	void cancel();
+
 	/**
 	 * Get the current result on the initial target, a SetLink with
 	 * all inferred atoms matching the target.
@@ -171,7 +265,97 @@ public:
 	Handle get_results() const;
 	const HandleSet& get_results_set() const;
 
+	/**
+	 * Like get_results_set but return a copy, safe to call while the
+	 * chainer is running in another thread.
+	 */
+	HandleSet copy_results() const;
+
+	/**
+	 * @return the profiling counters, only recorded if
+	 * URE:collect-stats is true.
+	 */
+	const ChainerStats& get_stats() const;
+
+	/**
+	 * Set a callback called on each result as soon as it is produced,
+	 * that is added to the knowledge-base, which allows to use
+	 * results before do_chain returns. A result may be passed again
+	 * if its truth value has been updated. If fulfillment is
+	 * asynchronous the callback is called from the fulfillment
+	 * threads, thus must be thread safe.
+	 */
+	void set_result_callback(const ResultCallback& cb);
+
+	/**
+	 * Return the leaves of all and-BITs of the BIT, each alongside
+	 * the declaration of its variables, if any.
+	 */
+	HandlePairSeq get_leaves() const;
+
+	/**
+	 * Fulfill all and-BITs containing at least one of the given
+	 * leaves, as returned by get_leaves. Useful when these leaves
+	 * have been proven outside of the chainer, for instance by
+	 * forward chaining. Return the number of fulfilled and-BITs.
+	 */
+	size_t fulfill_andbits(const HandleSet& leaves);
+
 private:
+	// Hold the intermediary states of an and-BIT expansion, used
+	// by parallel expansion.
+	struct Expansion
+	{
+		AndBIT* andbit;
+		BITNode* bitleaf;
+		Handle andbit_fcs;
+		Handle bitleaf_body;
+		RuleCandidates candidates;
+		RuleSelection rule_sel;
+		AndBIT new_andbit;
+
+		// Random generator of the threads processing that
+		// expansion, used for alpha-conversion
+		std::shared_ptr<MT19937RandGen> rng;
+	};
+
+	// Discard the rules with no path back to the knowledge-base,
+	// according to the rule dependency graph.
+	void prune_rules();
+
+	// Decompose the target, if conjunctive, and solve its sub-targets
+	// with sub-chainers, see TargetDecomposer. The results of the
+	// sub-chainers are added to the knowledge-base, then joined by
+	// join_subtargets.
+	void decompose_target();
+
+	// Initialize the BIT and fulfill its initial and-BIT, thus
+	// joining the results of the sub-targets present in the
+	// knowledge-base. If it produces results, the target is deemed
+	// solved and backward chaining terminates, see _joined.
+	void join_subtargets();
+
+	// Solve each sub-target with its own sub-chainer, concurrently,
+	// each sub-chainer using its own random generator.
+	void solve_subtargets(const HandleSeq& subtargets);
+
+	// Perform a step expanding and fulfilling a single and-BIT
+	void do_step_singlethread();
+
+	// Perform a step expanding and fulfilling, in parallel, as many
+	// distinct and-BITs as jobs.
+	void do_step_multithread();
+
+	// Perform a beam generation. Every expandable and-BIT of the BIT
+	// is expanded once, with up to jobs threads, then the BIT is
+	// pruned to its beam width. Each expansion counts as an
+	// iteration.
+	void do_step_beam();
+
+	// Keep only the beam width heaviest and-BITs of the BIT, ties
+	// being broken by the order of the and-BITs, thus simpler first.
+	void prune_beam();
+
 	void expand_meta_rules();
 
 	// Expand the BIT
@@ -181,13 +365,57 @@ private:
 	// will keep a record of the expansion if successful.
 	void expand_bit(AndBIT& andbit);
 
+	// Expand in parallel the given distinct and-BITs, and fulfill the
+	// resulting and-BITs as soon as they are produced. The selection
+	// of leaves and rules, which involves the random generator, as
+	// well as the insertion of the new and-BITs in the BIT, are done
+	// sequentially, the rest, unification, control rules evaluation,
+	// and-BIT expansion and fulfillment, is done in parallel.
+	void expand_bit(const std::vector<AndBIT*>& andbits);
+
+	// Add the rule to the BIT atomspace and return true iff it can be
+	// used for expansion.
+	bool validate_rule(Rule& rule);
+
 	// Fulfill the BIT. That is run some or all its and-BITs
 	void fulfill_bit();
 
+	// Fulfill an FCS, either immediately or, if asynchronous
+	// fulfillment is enabled, by pushing it to the fulfillment queue.
+	// If fulfillment batching is enabled, the FCS is only added to
+	// the pending batch, which gets flushed once full. Errors are
+	// ignored, in case the pattern matcher can't handle the FCS.
+	void schedule_fulfillment(const Handle& fcs);
+
+	// Fulfill the FCSs of the pending batch, group by group, either
+	// immediately or by pushing the groups to the fulfillment queue.
+	void flush_fulfillment_batch();
+
 	// Fulfill an FCS (i.e and-BIT). That is run its forward chaining
 	// strategy.
 	void fulfill_fcs(const Handle& fcs);
 
+	// Fulfill a group of FCSs sharing common clauses, see
+	// FCSBatch::execute.
+	void fulfill_fcs_group(const HandleSeq& group);
+
+	// Add the results of an FCS to the knowledge-base and the
+	// results set, record them in the trace atomspace and pass them
+	// to the result callback, if any.
+	void add_results(const Handle& fcs, const HandleSeq& results);
+
+	// Return true iff enough results have reached the confidence
+	// threshold, if enabled.
+	bool is_answered() const;
+
+	// Return true if the FCS is known to have no grounding in the
+	// knowledge-base, according to the clause planner.
+	bool is_unsatisfiable(const Handle& fcs);
+
+	// Return the plan of the clauses of an FCS over the
+	// knowledge-base.
+	ClausePlan plan_fcs(const Handle& fcs);
+
 	// Reduce the BIT. Remove some and-BITs.
 	void reduce_bit();
 
@@ -202,6 +430,43 @@ private:
 	// Select an and-BIT for expansion
 	AndBIT* select_expansion_andbit();
 
+	// Select up to n distinct and-BITs for expansion, without
+	// replacement. Fewer than n are returned if there are not enough
+	// and-BITs with non-null weights.
+	std::vector<AndBIT*> select_expansion_andbits(size_t n);
+
+	// Deterministically select up to n distinct and-BITs for
+	// expansion, either by increasing estimated cost (best-first), or
+	// by decreasing complexity amongst the ones with estimated cost
+	// within _cost_bound (iterative deepening). Return an empty
+	// vector if no and-BIT has a finite estimated cost, in which case
+	// the and-BITs are sampled as usual.
+	std::vector<AndBIT*> select_best_andbits(size_t n);
+
+	// Return true iff and-BITs are selected deterministically
+	bool is_deterministic() const;
+
+	// Remove the and-BIT with the highest estimated cost, used
+	// instead of remove_unlikely_expandable_andbit when and-BITs are
+	// selected deterministically.
+	void remove_most_costly_andbit();
+
+	// Return the estimated cost of proving the target via an and-BIT,
+	// its complexity plus an admissible estimate of the complexity
+	// left. Infinite if the and-BIT cannot lead to a proof or cannot
+	// be expanded.
+	std::vector<double> expansion_andbit_costs();
+	double estimated_cost(const AndBIT& andbit);
+
+	// Lower bound of the complexity left to prove the leaves of an
+	// and-BIT. Each leaf without grounding in the knowledge-base,
+	// according to the clause planner, requires at least one more
+	// expansion, costing at least 1 plus its BIT-node complexity (the
+	// rule probability term being non-negative, see
+	// AndBIT::expand_complexity). Infinite if such a leaf is
+	// exhausted.
+	double cost_heuristic(const AndBIT& andbit);
+
 	// Select an and-BIT for fulfilment. Return nullptr if none have
 	// been selected.
 	const AndBIT* select_fulfillment_andbit() const;
@@ -222,6 +487,14 @@ private:
 	// Atomspace containing the rule base, can be the same as _kb_as
 	AtomSpace& _rb_as;
 
+	// Rule-base, target, its variable declaration and the control
+	// atomspace, kept to build the sub-chainers of the target
+	// decomposition.
+	const Handle _rbs;
+	const Handle _target;
+	const Handle _vardecl;
+	AtomSpace* _control_as;
+
 	// Contain the configuration
 	UREConfig _config;
 
@@ -242,11 +515,49 @@ private:
 
 	int _iteration;
 
+	// Bound of the estimated cost of the and-BITs selected for
+	// expansion, only used by iterative deepening.
+	double _cost_bound;
+
 	// Keep track of the and-BIT of the last expansion. Null if the
 	// last expansion has failed.
 	const AndBIT* _last_expansion_andbit;
 
 	HandleSet _results;
+
+	// Protect _results, which may be populated by multiple threads
+	mutable std::mutex _results_mutex;
+
+	// Whether the results of the sub-targets of the target
+	// decomposition have been successfully joined. The sub-chainers
+	// have already searched with the same budget, thus the search is
+	// not repeated over the whole target.
+	bool _joined;
+
+	// Set by cancel, possibly from another thread
+	std::atomic<bool> _cancelled;
+
+	// Profiling counters
+	ChainerStats _stats;
+
+	// Results with a confidence reaching the confidence threshold,
+	// protected by _results_mutex as well.
+	HandleSet _confident_results;
+
+	ResultCallback _result_callback;
+
+	// FCSs pending fulfillment, only used when fulfillment batching
+	// is enabled.
+	FCSBatch _fulfillment_batch;
+
+	// Estimate the selectivity of FCS clauses, to avoid running
+	// FCSs that cannot be satisfied.
+	ClausePlanner _clause_planner;
+
+	// Queue of and-BITs pending fulfillment, only used when
+	// fulfillment is asynchronous. Declared last so that its workers
+	// are joined before the other members get destroyed.
+	std::unique_ptr<FulfillmentQueue> _fulfillment_queue;
 };
 
 
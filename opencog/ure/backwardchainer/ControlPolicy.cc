@@ -21,6 +21,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <boost/range/algorithm/sort.hpp>
+
 #include <opencog/util/random.h>
 #include <opencog/util/algorithm.h>
 #include <opencog/unify/Unify.h>
@@ -37,36 +39,46 @@
 
 using namespace opencog;
 
-#define al _query_as->add_link
-#define an _query_as->add_node
+const size_t ControlPolicy::control_rule_activities_max_size = 65536;
 
 ControlPolicy::ControlPolicy(const UREConfig& ure_config, const BIT& bit,
-                             const Handle& target, AtomSpace* control_as) :
+                             const Handle& target, AtomSpace* control_as,
+                             std::shared_ptr<ControlRuleIndex> control_index) :
 	rules(ure_config.get_rules()), _ure_config(ure_config),
-	_bit(bit), _target(target), _control_as(control_as), _query_as(nullptr)
+	_bit(bit), _target(target), _control_as(control_as),
+	_control_index(control_index)
 {
 	// Fetch default TVs for each inference rule (the TV on the member
 	// link connecting the rule to the rule base)
 	for (RulePtr rule : rules) {
 		_default_tvs[rule->get_alias()] = rule->get_tv();
 	}
-	std::stringstream ss;
-	ss << "Default inference rule TVs:";
-	for (const auto& rtv : _default_tvs)
-		ss << std::endl << rtv.second->to_string() << " " << oc_to_string(rtv.first);
-	ure_logger().debug() << ss.str();
+	if (URE_LOG_DEBUG_ENABLED) {
+		std::stringstream ss;
+		ss << "Default inference rule TVs:";
+		for (const auto& rtv : _default_tvs)
+			ss << std::endl << rtv.second->to_string() << " " << oc_to_string(rtv.first);
+		LAZY_URE_LOG_DEBUG << ss.str();
+	}
 
-	// Fetches expansion control rules from _control_as
+	// Fetches expansion control rules from the index of _control_as
 	if (_control_as) {
-		_query_as = createAtomSpace(_control_as);
-		_query_as->clear_copy_on_write(); // _as should be write-through.
+		if (not _control_index)
+			_control_index = std::make_shared<ControlRuleIndex>(*_control_as);
 		for (const Handle& rule_alias : rules.aliases()) {
-			HandleSet exp_ctrl_rules = fetch_expansion_control_rules(rule_alias);
+			HandleSet exp_ctrl_rules =
+				_control_index->expansion_control_rules(rule_alias);
 			_expansion_control_rules[rule_alias] = exp_ctrl_rules;
-
-			ure_logger().debug() << "Expansion control rules for "
-			                     << rule_alias->to_string()
-			                     << oc_to_string(exp_ctrl_rules);
+			for (const Handle& ctrl_rule : exp_ctrl_rules) {
+				_control_rule_matchers.emplace(ctrl_rule,
+				                               mk_control_rule_matcher(ctrl_rule));
+				_control_rule_stats.emplace(ctrl_rule,
+				                            MixtureModel::get_model_stats(ctrl_rule));
+			}
+
+			LAZY_URE_LOG_DEBUG << "Expansion control rules for "
+			                   << rule_alias->to_string()
+			                   << oc_to_string(exp_ctrl_rules);
 		}
 	}
 }
@@ -75,25 +87,60 @@ ControlPolicy::~ControlPolicy()
 {
 }
 
+std::shared_ptr<ControlRuleIndex> ControlPolicy::get_control_rule_index() const
+{
+	return _control_index;
+}
+
 RuleSelection ControlPolicy::select_rule(AndBIT& andbit, BITNode& bitleaf)
 {
-	// The rule is randomly selected amongst the valid ones, with
-	// probability of selection being proportional to its weight.
-	const RuleTypedSubstitutionMap valid_rules = get_valid_rules(andbit, bitleaf);
-	if (valid_rules.empty()) {
+	return select_rule(rule_candidates(andbit, bitleaf));
+}
+
+RuleCandidates ControlPolicy::rule_candidates(const AndBIT& andbit,
+                                              BITNode& bitleaf)
+{
+	RuleCandidates candidates;
+	candidates.rules = get_valid_rules(andbit, bitleaf);
+	if (candidates.rules.empty()) {
 		bitleaf.exhausted = true;
-		return RuleSelection();
+		return candidates;
 	}
 
 	// Log all valid rules
-	if (ure_logger().is_debug_enabled()) {
+	if (URE_LOG_DEBUG_ENABLED) {
 		std::stringstream ss;
 		ss << "The following rules are valid:" << std::endl
-		   << oc_to_string(rule_aliases(valid_rules));
+		   << oc_to_string(rule_aliases(candidates.rules));
 		LAZY_URE_LOG_DEBUG << ss.str();
 	}
 
-	return select_rule(andbit, bitleaf, valid_rules);
+	// Build a mapping from rule to TV of expansion success, and
+	// calculate the rule weights accordingly
+	candidates.success_tvs =
+		expansion_success_tvs(andbit, bitleaf, candidates.rules);
+	candidates.weights = rule_weights(candidates.success_tvs, candidates.rules);
+	return candidates;
+}
+
+RuleSelection ControlPolicy::select_rule(const RuleCandidates& candidates) const
+{
+	if (candidates.rules.empty())
+		return RuleSelection();
+
+	// The rule is randomly selected amongst the valid ones, with
+	// probability of selection being proportional to its weight.
+	std::discrete_distribution<size_t> dist(candidates.weights.begin(),
+	                                        candidates.weights.end());
+	const RuleTypedSubstitutionPair& selected_rule =
+		*std::next(candidates.rules.begin(), dist(ure_rand_gen()));
+
+	// Return the selected rule and its probability of success, will
+	// be used to calculate the TV that the produce and-BIT is a
+	// preproof.
+	const Handle& alias = selected_rule.first.get_alias();
+	double prob = get_actual_mean(candidates.success_tvs.at(alias));
+	return {selected_rule, prob};
 }
 
 HandleSet ControlPolicy::rule_aliases(const RuleTypedSubstitutionMap& rules)
@@ -137,25 +184,6 @@ RuleTypedSubstitutionMap ControlPolicy::get_valid_rules(const AndBIT& andbit,
 	return valid_rules;
 }
 
-RuleSelection ControlPolicy::select_rule(const AndBIT& andbit,
-                                         const BITNode& bitleaf,
-                                         const RuleTypedSubstitutionMap& inf_rules)
-{
-	// Build a mapping from rule to TV of expansion success
-	HandleTVMap success_tvs = expansion_success_tvs(andbit, bitleaf, inf_rules);
-	std::vector<double> weights = rule_weights(success_tvs, inf_rules);
-
-	// Sample an inference rule according to the distribution
-	std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
-	const RuleTypedSubstitutionPair& selected_rule = rand_element(inf_rules, dist);
-
-	// Return the selected rule and its probability of success, will
-	// be used to calculate the TV that the produce and-BIT is a
-	// preproof.
-	double prob = get_actual_mean(success_tvs[selected_rule.first.get_alias()]);
-	return {selected_rule, prob};
-}
-
 HandleTVMap ControlPolicy::expansion_success_tvs(
 	const AndBIT& andbit,
 	const BITNode& bitleaf,
@@ -171,29 +199,53 @@ HandleTVMap ControlPolicy::expansion_success_tvs(
 
 		if (active_ctrl_rules.empty()) {
 			// If there are no active control rules, use the default
-			// TV on the rule.
-			success_tvs[rule] = _default_tvs[rule];
+			// TV on the rule. Use find rather than operator[] as
+			// this may be called concurrently.
+			auto dtv_it = _default_tvs.find(rule);
+			success_tvs[rule] = dtv_it != _default_tvs.end() ?
+				dtv_it->second : TruthValuePtr();
 		} else {
 			// Otherwise calculate the truth value of its mixture
 			// model.
-			double cpx_penalty = _ure_config.get_mm_complexity_penalty(),
-				compressiveness = _ure_config.get_mm_compressiveness();
-			success_tvs[rule] = MixtureModel(active_ctrl_rules,
-			                                 cpx_penalty, compressiveness)();
+			success_tvs[rule] = mixture_tv(active_ctrl_rules);
 		}
 	}
 
 	// Log TVs of representing probability of success (expanding into
 	// a preproof) for each action
-	std::stringstream ss;
-	ss << "Rule TVs of expanding a preproof into another preproof:" << std::endl;
-	for (const auto& rtv : success_tvs)
-		ss << rtv.second->to_string() << " " << oc_to_string(rtv.first);
-	ure_logger().debug() << ss.str();
+	if (URE_LOG_DEBUG_ENABLED) {
+		std::stringstream ss;
+		ss << "Rule TVs of expanding a preproof into another preproof:" << std::endl;
+		for (const auto& rtv : success_tvs)
+			ss << rtv.second->to_string() << " " << oc_to_string(rtv.first);
+		LAZY_URE_LOG_DEBUG << ss.str();
+	}
 
 	return success_tvs;
 }
 
+TruthValuePtr ControlPolicy::mixture_tv(const HandleSet& active_ctrl_rules) const
+{
+	double cpx_penalty = _ure_config.get_mm_complexity_penalty(),
+		compressiveness = _ure_config.get_mm_compressiveness();
+	HandleSeq sorted_rules(active_ctrl_rules.begin(), active_ctrl_rules.end());
+	boost::sort(sorted_rules);
+	MixtureKey key(sorted_rules, cpx_penalty, compressiveness);
+	{
+		std::lock_guard<std::mutex> lock(_mixture_tvs_mutex);
+		auto it = _mixture_tvs.find(key);
+		if (it != _mixture_tvs.end())
+			return it->second;
+	}
+
+	TruthValuePtr tv = MixtureModel(active_ctrl_rules, cpx_penalty,
+	                                compressiveness, &_control_rule_stats)();
+
+	std::lock_guard<std::mutex> lock(_mixture_tvs_mutex);
+	_mixture_tvs[key] = tv;
+	return tv;
+}
+
 std::vector<double> ControlPolicy::rule_weights(const HandleTVMap& success_tvs,
                                                 const RuleTypedSubstitutionMap& inf_rules)
 {
@@ -204,17 +256,16 @@ std::vector<double> ControlPolicy::rule_weights(const HandleTVMap& success_tvs,
 	HandleCounter alias_weights = action_selection.distribution();
 
 	// Log rule weights for action selection
-	std::stringstream ssw;
-	ssw << "Rule weights:" << std::endl;
-	for (const auto& rw : alias_weights)
-		ssw << rw.second << " " << oc_to_string(rw.first);
-	ure_logger().debug() << ssw.str();
+	if (URE_LOG_DEBUG_ENABLED) {
+		std::stringstream ssw;
+		ssw << "Rule weights:" << std::endl;
+		for (const auto& rw : alias_weights)
+			ssw << rw.second << " " << oc_to_string(rw.first);
+		LAZY_URE_LOG_DEBUG << ssw.str();
+	}
 
 	// Reweight over rule instances and normalize
-	rule_weights(alias_weights, inf_rules);
-	std::vector<double> norm_weights = rule_weights(alias_weights, inf_rules);
-
-	return norm_weights;
+	return rule_weights(alias_weights, inf_rules);
 }
 
 std::vector<double> ControlPolicy::rule_weights(
@@ -246,19 +297,22 @@ HandleSet ControlPolicy::active_expansion_control_rules(
 
 	// Filter out inactive expansion control rules
 	HandleSet results;
-	for (const Handle& ctrl_rule : _expansion_control_rules[inf_rule_alias])
+	auto ecr_it = _expansion_control_rules.find(inf_rule_alias);
+	if (ecr_it == _expansion_control_rules.end())
+		return results;
+	for (const Handle& ctrl_rule : ecr_it->second)
 		if (is_control_rule_active(andbit, bitleaf, ctrl_rule))
 			results.insert(ctrl_rule);
 
 	// Log active control rules, if any
-	if (not results.empty()) {
+	if (not results.empty() and URE_LOG_DEBUG_ENABLED) {
 		std::stringstream ss;
 		ss << "Active expansion control rules for "
 		   << inf_rule_alias->to_string()
 		   << "size = " << results.size() << ":";
 		for (const Handle& acr : results)
 			ss << " " << acr->id_to_string();
-		ure_logger().debug() << ss.str();
+		LAZY_URE_LOG_DEBUG << ss.str();
 	}
 
 	return results;
@@ -267,6 +321,44 @@ HandleSet ControlPolicy::active_expansion_control_rules(
 bool ControlPolicy::is_control_rule_active(const AndBIT& andbit,
                                            const BITNode& bitleaf,
                                            const Handle& ctrl_rule) const
+{
+	ActivityKey key(ctrl_rule, andbit.fcs, bitleaf.body);
+	{
+		std::lock_guard<std::mutex> lock(_control_rule_activities_mutex);
+		auto it = _control_rule_activities.find(key);
+		if (it != _control_rule_activities.end())
+			return it->second;
+	}
+
+	bool active;
+	auto mit = _control_rule_matchers.find(ctrl_rule);
+	if (mit != _control_rule_matchers.end() and mit->second.is_compiled())
+		active = mit->second.is_active(createLink(DONT_EXEC_LINK, andbit.fcs),
+		                               bitleaf.body);
+	else
+		active = is_control_rule_active_pm(andbit, bitleaf, ctrl_rule);
+
+	std::lock_guard<std::mutex> lock(_control_rule_activities_mutex);
+	if (control_rule_activities_max_size <= _control_rule_activities.size())
+		_control_rule_activities.clear();
+	_control_rule_activities[key] = active;
+	return active;
+}
+
+ControlRuleMatcher ControlPolicy::mk_control_rule_matcher(const Handle& ctrl_rule) const
+{
+	Handle ctrl_ante_preproof = get_antecedent_preproof(ctrl_rule),
+		ctrl_target = ctrl_ante_preproof->getOutgoingAtom(1)->getOutgoingAtom(1),
+		ctrl_exp_input = get_expansion(ctrl_rule)->getOutgoingAtom(1),
+		ctrl_andbit = ctrl_exp_input->getOutgoingAtom(0),
+		ctrl_bitleaf = ctrl_exp_input->getOutgoingAtom(1);
+	return ControlRuleMatcher(ScopeLinkCast(ctrl_rule)->get_variables(),
+	                          ctrl_target, ctrl_andbit, ctrl_bitleaf, _target);
+}
+
+bool ControlPolicy::is_control_rule_active_pm(const AndBIT& andbit,
+                                              const BITNode& bitleaf,
+                                              const Handle& ctrl_rule) const
 {
 	Handle
 		// Control rule components
@@ -340,7 +432,7 @@ bool ControlPolicy::is_antecedent_preproof(const Handle& h) const
 {
 	if (h->get_type() == EVALUATION_LINK) {
 		Handle schema = h->getOutgoingAtom(0);
-		return schema->get_name() == preproof_predicate_name;
+		return schema->get_name() == ControlRuleIndex::preproof_predicate_name;
 	}
 	return false;
 }
@@ -363,133 +455,7 @@ bool ControlPolicy::is_expansion(const Handle& h) const
 	return false;
 }
 
-HandleSet ControlPolicy::fetch_expansion_control_rules(const Handle& inf_rule)
-{
-	return set_union(fetch_expansion_control_rules(inf_rule, 0),
-	                 fetch_expansion_control_rules(inf_rule, 1));
-}
-
-HandleSet ControlPolicy::fetch_expansion_control_rules(const Handle& inf_rule,
-                                                       int n)
-{
-	Handle query = mk_expansion_control_rules_query(inf_rule, n);
-	Handle result = HandleCast(query->execute(_control_as));
-	HandleSeq outgoings(result->getOutgoingSet());
-	_control_as->remove_atom(result); // Remove cruft from _control_as
-	return HandleSet(outgoings.begin(), outgoings.end());
-}
-
-Handle ControlPolicy::mk_vardecl_vardecl(const Handle& vardecl_var)
-{
-	return al(TYPED_VARIABLE_LINK,
-	          vardecl_var,
-	          al(TYPE_CHOICE,
-	             an(TYPE_NODE, "VariableList"),
-	             an(TYPE_NODE, "VariableNode"),
-	             an(TYPE_NODE, "TypedVariableLink")));
-}
-
-Handle ControlPolicy::mk_list_of_args_vardecl(const Handle& args_var)
-{
-	return al(TYPED_VARIABLE_LINK,
-	          args_var,
-	          an(TYPE_NODE, "ListLink"));
-}
-
-Handle ControlPolicy::mk_expand_exec(const Handle& input_andbit_var,
-                                     const Handle& input_leaf_var,
-                                     const Handle& inf_rule,
-                                     const Handle& output_andbit_var)
-{
-	Handle expand_schema = an(SCHEMA_NODE,
-		std::move(std::string(TraceRecorder::expand_andbit_schema_name)));
-	return al(EXECUTION_LINK,
-	          expand_schema,
-	          al(LIST_LINK,
-	             al(UNQUOTE_LINK, input_andbit_var),
-	             al(UNQUOTE_LINK, input_leaf_var),
-	             al(DONT_EXEC_LINK, inf_rule)),
-	          al(UNQUOTE_LINK, output_andbit_var));
-}
-
-Handle ControlPolicy::mk_preproof_eval(const Handle& preproof_args_var)
-{
-	Handle preproof_pred = an(PREDICATE_NODE,
-	                          std::move(std::string(preproof_predicate_name)));
-	return al(EVALUATION_LINK,
-	          preproof_pred,
-	          al(UNQUOTE_LINK, preproof_args_var));
-}
-
-Handle ControlPolicy::mk_expansion_control_rules_query(const Handle& inf_rule,
-                                                       int n)
-{
-	Handle vardecl_var = an(VARIABLE_NODE, "$vardecl"),
-		vardecl_vardecl = mk_vardecl_vardecl(vardecl_var),
-
-		in_preproof_args_var = an(VARIABLE_NODE, "$in_preproof_args"),
-		in_preproof_args_vardecl = mk_list_of_args_vardecl(in_preproof_args_var),
-		in_preproof_eval = mk_preproof_eval(in_preproof_args_var),
-
-		in_andbit_var = an(VARIABLE_NODE, "$in_andbit"),
-		in_leaf_var = an(VARIABLE_NODE, "$in_leaf"),
-		out_andbit_var = an(VARIABLE_NODE, "$out_andbit"),
-		expand_exec = mk_expand_exec(in_andbit_var, in_leaf_var, inf_rule,
-		                             out_andbit_var),
-
-		out_preproof_args_var = an(VARIABLE_NODE, "$out_preproof_args"),
-		out_preproof_args_vardecl = mk_list_of_args_vardecl(out_preproof_args_var),
-		out_preproof_eval = mk_preproof_eval(out_preproof_args_var);
-
-	HandleSeq pattern_vars = mk_pattern_vars(n);
-
-	// ImplicationScope with a pattern in its antecedent to
-	// retrieve
-	HandleSeq antecedents{in_preproof_eval, expand_exec};
-	for (const Handle& pv : pattern_vars)
-		antecedents.push_back(al(UNQUOTE_LINK, pv));
-	Handle pat_expand_preproof_impl = al(QUOTE_LINK,
-	                                     al(IMPLICATION_SCOPE_LINK,
-	                                        al(UNQUOTE_LINK, vardecl_var),
-	                                        al(AND_LINK, std::move(antecedents)),
-	                                        out_preproof_eval));
-
-	// Bind of ImplicationScope with a pattern in its antecedent
-	// to retrieve
-	HandleSeq vardecls{vardecl_vardecl,
-	                   in_preproof_args_vardecl,
-	                   in_andbit_var,
-	                   in_leaf_var,
-	                   out_andbit_var,
-	                   out_preproof_args_vardecl};
-	vardecls.insert(vardecls.end(), pattern_vars.begin(), pattern_vars.end());
-
-	Handle pat_expand_preproof_impl_bl = al(BIND_LINK,
-	                                        al(VARIABLE_LIST, std::move(vardecls)),
-	                                        pat_expand_preproof_impl,
-	                                        pat_expand_preproof_impl);
-
-	return pat_expand_preproof_impl_bl;
-}
-
-HandleSeq ControlPolicy::mk_pattern_vars(int n)
-{
-	HandleSeq pattern_vars;
-	for (int i = 0; i < n; i++)
-		pattern_vars.push_back(mk_pattern_var(i));
-	return pattern_vars;
-}
-
-Handle ControlPolicy::mk_pattern_var(int i)
-{
-	std::string name = std::string("$pattern-") + std::to_string(i);
-	return an(VARIABLE_NODE, std::move(name));
-}
-
 double ControlPolicy::get_actual_mean(TruthValuePtr tv) const
 {
 	return BetaDistribution(tv).mean();
 }
-
-#undef al
-#undef an
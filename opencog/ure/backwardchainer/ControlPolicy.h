@@ -25,7 +25,13 @@
 
 #include <opencog/atomspace/AtomSpace.h>
 
+#include <mutex>
+#include <tuple>
+
 #include "BIT.h"
+#include "ControlRuleIndex.h"
+#include "ControlRuleMatcher.h"
+#include "../MixtureModel.h"
 #include "../UREConfig.h"
 #include "../Rule.h"
 
@@ -44,15 +50,42 @@ typedef std::map<Handle, TruthValuePtr> HandleTVMap;
 // TODO: maybe wrap that in a class, and use it in foward chainer
 typedef std::pair<RuleTypedSubstitutionPair, double> RuleSelection;
 
+// Hold the valid inference rules to expand a given BIT-node, their
+// TVs of expansion success (indexed by rule alias) and their
+// selection weights (in the same order as rules).
+struct RuleCandidates
+{
+	RuleTypedSubstitutionMap rules;
+	HandleTVMap success_tvs;
+	std::vector<double> weights;
+};
+
 class ControlPolicy
 {
 	friend class ::ControlPolicyUTest;
 public:
+	/**
+	 * The expansion control rules of control_as are looked up in
+	 * control_index if provided, otherwise in an index of control_as
+	 * built for that control policy. In both cases, the index can
+	 * then be shared with other control policies, see
+	 * get_control_rule_index.
+	 *
+	 * A provided index is used as is, it only reflects the control
+	 * rules added or removed through its own insert and remove
+	 * methods, thus must be rebuilt (see ControlRuleIndex::rebuild)
+	 * if control_as has been modified by other means since.
+	 */
 	ControlPolicy(const UREConfig& ure_config, const BIT& bit,
-	              const Handle& target, AtomSpace* control_as=nullptr);
+	              const Handle& target, AtomSpace* control_as=nullptr,
+	              std::shared_ptr<ControlRuleIndex> control_index=nullptr);
 	~ControlPolicy();
 
-	const std::string preproof_predicate_name = "URE:BC:preproof-of";
+	/**
+	 * Return the index of the control rules of the control
+	 * atomspace, nullptr if there is no control atomspace.
+	 */
+	std::shared_ptr<ControlRuleIndex> get_control_rule_index() const;
 
 	// Inference rule set for expanding and-BITs.
 	RuleSet rules;
@@ -75,6 +108,28 @@ public:
 	 */
 	RuleSelection select_rule(AndBIT& andbit, BITNode& bitleaf);
 
+	/**
+	 * Calculate the valid inference rules to expand bitleaf of
+	 * andbit, alongside their TVs of success and selection
+	 * weights. This is the expensive part of rule selection
+	 * (unification and control rules evaluation). Since it only
+	 * modifies bitleaf, it may be called concurrently over distinct
+	 * and-BITs, provided each thread installs its own random
+	 * generator with ScopedRandGen, the one alpha-conversion draws
+	 * fresh variable names from.
+	 *
+	 * If there are no valid rules, the bitleaf exhausted flag is set
+	 * to true.
+	 */
+	RuleCandidates rule_candidates(const AndBIT& andbit, BITNode& bitleaf);
+
+	/**
+	 * Randomly select an inference rule amongst candidates, according
+	 * to their weights. Return an empty selection if there are no
+	 * candidates.
+	 */
+	RuleSelection select_rule(const RuleCandidates& candidates) const;
+
 	/**
 	 * Return the set of rule aliases (i,e. DefineSchema pointing to
 	 * rule names).
@@ -106,14 +161,37 @@ private:
 	//    expand an and-BIT.
 	AtomSpace* _control_as;
 
-	// AtomSpace holding the pattern matcher queries to fetch the
-	// various control rule
-	AtomSpacePtr _query_as;
+	// Index of the expansion control rules of _control_as, possibly
+	// shared with other control policies.
+	std::shared_ptr<ControlRuleIndex> _control_index;
 
 	// Map each action (inference rule expansion) to the set of
 	// control rules involving it.
 	std::map<Handle, HandleSet> _expansion_control_rules;
 
+	// Map each expansion control rule to its compiled matcher
+	std::map<Handle, ControlRuleMatcher> _control_rule_matchers;
+
+	// Statistics of the expansion control rules, precomputed once
+	// for all mixture models.
+	MixtureModel::ModelStatsMap _control_rule_stats;
+
+	// Memoize the TV of the mixture model of a set of active control
+	// rules (sorted), given the complexity penalty and
+	// compressiveness parameters.
+	typedef std::tuple<HandleSeq, double, double> MixtureKey;
+	mutable std::map<MixtureKey, TruthValuePtr> _mixture_tvs;
+	mutable std::mutex _mixture_tvs_mutex;
+
+	// Memoize whether a control rule is active, given an and-BIT
+	// (its FCS) and a BIT-leaf (its body). Emptied once it holds
+	// control_rule_activities_max_size entries, like ClausePlanner,
+	// since the and-BITs it refers to may have been erased meanwhile.
+	typedef std::tuple<Handle, Handle, Handle> ActivityKey;
+	static const size_t control_rule_activities_max_size;
+	mutable std::map<ActivityKey, bool> _control_rule_activities;
+	mutable std::mutex _control_rule_activities_mutex;
+
 	/**
 	 * Return all valid inference rules, in the sense that they may
 	 * possibly be used to infer the target.
@@ -121,14 +199,6 @@ private:
 	RuleTypedSubstitutionMap get_valid_rules(const AndBIT& andbit,
 	                                         const BITNode& bitleaf);
 
-	/**
-	 * Select an inference rule for expansion amongst a set of valid
-	 * ones.
-	 */
-	RuleSelection select_rule(const AndBIT& andbit,
-	                          const BITNode& bitleaf,
-	                          const RuleTypedSubstitutionMap& rules);
-
 	/**
 	 * Return the conditional TVs that a given rule expands a supposed
 	 * preproof into another preproof.
@@ -137,6 +207,12 @@ private:
 	                                  const BITNode& bitleaf,
 	                                  const RuleTypedSubstitutionMap& rules);
 
+	/**
+	 * Return the TV of the mixture model of the given active control
+	 * rules. Memoized.
+	 */
+	TruthValuePtr mixture_tv(const HandleSet& active_ctrl_rules) const;
+
 	/**
 	 * Calculate the rule weights, according to the control rules
 	 * present is _control_as, or otherwise default rule TVs, to do
@@ -185,11 +261,27 @@ private:
 	 * will have a certain probability of being true, or some degree
 	 * of truth. To do well it should rely on a conditional
 	 * instantiation PLN rule.
+	 *
+	 * The outcome is memoized, and calculated by the compiled matcher
+	 * of the control rule if any, otherwise by the pattern matcher.
 	 */
 	bool is_control_rule_active(const AndBIT& andbit,
 	                            const BITNode& bitleaf,
 	                            const Handle& ctrl_rule) const;
 
+	/**
+	 * Like is_control_rule_active but use the pattern matcher, for
+	 * control rules that cannot be compiled.
+	 */
+	bool is_control_rule_active_pm(const AndBIT& andbit,
+	                               const BITNode& bitleaf,
+	                               const Handle& ctrl_rule) const;
+
+	/**
+	 * Compile the antecedent of a control rule into a matcher
+	 */
+	ControlRuleMatcher mk_control_rule_matcher(const Handle& ctrl_rule) const;
+
 	/**
 	 * Given a pattern, with an optional variable declaration vardecl,
 	 * and a term, check whether the pattern matches the term. This is
@@ -251,62 +343,6 @@ private:
 	Handle get_expansion(const Handle& ctrl_rule) const;
 	bool is_expansion(const Handle& h) const;
 
-	/**
-	 * Given an inference rule, fetch both pattern and pattern free
-	 * expansion control rules. See comments below.
-	 */
-	HandleSet fetch_expansion_control_rules(const Handle& inf_rule);
-
-	/**
-	 * Fetch control rules from _control_as involved in BIT
-	 * expansion. Informally that if and-BIT, A, is a preproof and
-	 * expands into B from L with the given rule, and follow some
-	 * pattern, then B has a probability TV of being a preproof of
-	 * T. Formally
-	 *
-	 * ImplicationScope <TV>
-	 *  <vardecl>
-	 *  And
-	 *    Evaluation
-	 *      Predicate "preproof-of"
-	 *      List
-	 *        <A>
-	 *        <T>
-	 *    Execution
-	 *      Schema "expand-and-BIT"
-	 *      List
-	 *        <A>
-	 *        <L>
-	 *        <inf_rule>
-	 *      <B>
-	 *    <pattern-1>
-	 *    ...
-	 *    <pattern-n>
-	 *  Evaluation
-	 *    Predicate "preproof"
-	 *    List
-	 *      <B>
-	 *      <T>
-	 *
-	 * n >= 0 is the number of patterns in addition to preproof and
-	 * expansion.
-	 */
-	HandleSet fetch_expansion_control_rules(const Handle& inf_rule, int n);
-
-	/**
-	 * Helpers to build various hypergraphs used to build various queries
-	 */
-	Handle mk_vardecl_vardecl(const Handle& vardecl_var);
-	Handle mk_list_of_args_vardecl(const Handle& args_var);
-	Handle mk_expand_exec(const Handle& input_andbit_var,
-	                      const Handle& input_leaf_var,
-	                      const Handle& inf_rule,
-	                      const Handle& output_andbit_var);
-	Handle mk_preproof_eval(const Handle& preproof_args_var);
-	Handle mk_expansion_control_rules_query(const Handle& inf_rule, int n);
-	HandleSeq mk_pattern_vars(int n);
-	Handle mk_pattern_var(int i);
-
 	/**
 	 * Calculate the actual mean of a TV. which is to be contrasted by
 	 * the mean in the TruthValue class which doesn't correspond to
@@ -0,0 +1,165 @@
+/*
+ * ControlRuleIndex.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/core/ScopeLink.h>
+
+#include "ControlRuleIndex.h"
+#include "TraceRecorder.h"
+#include "../URELogger.h"
+
+using namespace opencog;
+
+const std::string ControlRuleIndex::preproof_predicate_name = "URE:BC:preproof-of";
+
+ControlRuleIndex::ControlRuleIndex(AtomSpace& control_as)
+	: _control_as(control_as)
+{
+	rebuild();
+}
+
+HandleSet ControlRuleIndex::expansion_control_rules(const Handle& rule_alias) const
+{
+	// The alias may come from another atomspace
+	Handle alias = _control_as.get_atom(rule_alias);
+	if (not alias)
+		return HandleSet();
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _expansion_control_rules.find(alias);
+	return it == _expansion_control_rules.end() ? HandleSet() : it->second;
+}
+
+Handle ControlRuleIndex::insert(const Handle& ctrl_rule)
+{
+	Handle h = _control_as.add_atom(ctrl_rule);
+	std::lock_guard<std::mutex> lock(_mutex);
+	index(h);
+	return h;
+}
+
+bool ControlRuleIndex::remove(const Handle& ctrl_rule)
+{
+	Handle h = _control_as.get_atom(ctrl_rule);
+	if (not h)
+		return false;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		Handle alias = get_rule_alias(h);
+		auto it = alias ? _expansion_control_rules.find(alias)
+			: _expansion_control_rules.end();
+		if (it != _expansion_control_rules.end()) {
+			it->second.erase(h);
+			if (it->second.empty())
+				_expansion_control_rules.erase(it);
+		}
+	}
+	return _control_as.extract_atom(h);
+}
+
+void ControlRuleIndex::rebuild()
+{
+	HandleSeq ctrl_rules;
+	_control_as.get_handles_by_type(ctrl_rules, IMPLICATION_SCOPE_LINK);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_expansion_control_rules.clear();
+	for (const Handle& h : ctrl_rules)
+		index(h);
+
+	LAZY_URE_LOG_DEBUG << "Indexed " << _expansion_control_rules.size()
+	                   << " inference rules with expansion control rules out of "
+	                   << ctrl_rules.size() << " control rule candidates";
+}
+
+size_t ControlRuleIndex::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	size_t s = 0;
+	for (const auto& el : _expansion_control_rules)
+		s += el.second.size();
+	return s;
+}
+
+Handle ControlRuleIndex::get_rule_alias(const Handle& ctrl_rule)
+{
+	// ImplicationScope
+	//   <vardecl>
+	//   And
+	//     <preproof-of-A>
+	//     Execution
+	//       Schema "URE:BC:expand-and-BIT"
+	//       List <A> <L> (DontExec <rule-alias>)
+	//       <B>
+	//     [<pattern>]
+	//   <preproof-of-B>
+	if (ctrl_rule->get_type() != IMPLICATION_SCOPE_LINK)
+		return Handle::UNDEFINED;
+	ScopeLinkPtr sc = ScopeLinkCast(ctrl_rule);
+	Handle body = sc->get_body();
+	const HandleSeq& outs = ctrl_rule->getOutgoingSet();
+	if (body->get_type() != AND_LINK or not is_preproof(outs.back()))
+		return Handle::UNDEFINED;
+
+	// Like the pattern matcher queries, only support up to one
+	// pattern in addition to the preproof and the expansion.
+	Arity arity = body->get_arity();
+	if (arity < 2 or 3 < arity)
+		return Handle::UNDEFINED;
+
+	Handle alias;
+	bool has_preproof = false;
+	for (const Handle& h : body->getOutgoingSet()) {
+		if (is_preproof(h))
+			has_preproof = true;
+		else if (is_expansion(h))
+			alias = h->getOutgoingAtom(1)->getOutgoingAtom(2)->getOutgoingAtom(0);
+	}
+	return has_preproof ? alias : Handle::UNDEFINED;
+}
+
+void ControlRuleIndex::index(const Handle& ctrl_rule)
+{
+	Handle alias = get_rule_alias(ctrl_rule);
+	if (alias)
+		_expansion_control_rules[alias].insert(ctrl_rule);
+}
+
+bool ControlRuleIndex::is_preproof(const Handle& h)
+{
+	return h->get_type() == EVALUATION_LINK
+		and h->get_arity() == 2
+		and h->getOutgoingAtom(0)->get_type() == PREDICATE_NODE
+		and h->getOutgoingAtom(0)->get_name() == preproof_predicate_name
+		and h->getOutgoingAtom(1)->get_type() == LIST_LINK;
+}
+
+bool ControlRuleIndex::is_expansion(const Handle& h)
+{
+	if (h->get_type() != EXECUTION_LINK or h->get_arity() != 3)
+		return false;
+	Handle schema = h->getOutgoingAtom(0), args = h->getOutgoingAtom(1);
+	if (schema->get_type() != SCHEMA_NODE
+	    or schema->get_name() != TraceRecorder::expand_andbit_schema_name
+	    or args->get_type() != LIST_LINK or args->get_arity() != 3)
+		return false;
+	Handle rule = args->getOutgoingAtom(2);
+	return rule->get_type() == DONT_EXEC_LINK and rule->get_arity() == 1;
+}
@@ -0,0 +1,141 @@
+/*
+ * ControlRuleIndex.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_CONTROLRULEINDEX_H_
+#define _OPENCOG_CONTROLRULEINDEX_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+namespace opencog
+{
+
+/**
+ * Index of the expansion control rules of a control atomspace, by
+ * inference rule alias.
+ *
+ * The index is built once, by classifying the ImplicationScopeLinks
+ * of the control atomspace, then maintained by adding and removing
+ * control rules through ControlRuleIndex::insert and
+ * ControlRuleIndex::remove, so that a lookup is a mere map find. It
+ * is owned by its users, and can be shared across backward chainers
+ * using the same control atomspace, see
+ * ControlPolicy::get_control_rule_index. Building a control policy
+ * thus merely amounts to a lookup, rather than running pattern
+ * matcher queries over the whole control atomspace.
+ *
+ * Control rules added to or removed from the control atomspace by
+ * other means are not reflected in the index, unless rebuilt with
+ * ControlRuleIndex::rebuild.
+ *
+ * Expansion control rules are recognized structurally, as
+ * ImplicationScopeLinks of the form
+ *
+ * ImplicationScope <TV>
+ *  <vardecl>
+ *  And
+ *    Evaluation
+ *      Predicate "URE:BC:preproof-of"
+ *      List <A> <T>
+ *    Execution
+ *      Schema "URE:BC:expand-and-BIT"
+ *      List <A> <L> (DontExec <inf_rule>)
+ *      <B>
+ *    <pattern-1>
+ *    ...
+ *    <pattern-n>
+ *  Evaluation
+ *    Predicate "URE:BC:preproof-of"
+ *    List <B> <T>
+ *
+ * meaning that if and-BIT A is a preproof of T and expands into B
+ * from leaf L with inf_rule, and the patterns hold, then B has a
+ * probability TV of being a preproof of T.
+ */
+class ControlRuleIndex
+{
+public:
+	/**
+	 * Build the index of the control rules currently in control_as.
+	 */
+	ControlRuleIndex(AtomSpace& control_as);
+
+	/**
+	 * Return the expansion control rules of the given inference rule
+	 * alias. Thread safe.
+	 */
+	HandleSet expansion_control_rules(const Handle& rule_alias) const;
+
+	/**
+	 * Add a control rule to the control atomspace and index it.
+	 * Thread safe.
+	 */
+	Handle insert(const Handle& ctrl_rule);
+
+	/**
+	 * Remove a control rule from the control atomspace and from the
+	 * index. Return true iff it has been removed from the control
+	 * atomspace. Thread safe.
+	 */
+	bool remove(const Handle& ctrl_rule);
+
+	/**
+	 * Rebuild the index from scratch, to take into account the
+	 * control rules added to or removed from the control atomspace
+	 * without going through insert or remove. Thread safe.
+	 */
+	void rebuild();
+
+	/**
+	 * Return the number of indexed expansion control rules.
+	 */
+	size_t size() const;
+
+	/**
+	 * Return the inference rule alias of an expansion control rule,
+	 * or Handle::UNDEFINED if it is not one.
+	 */
+	static Handle get_rule_alias(const Handle& ctrl_rule);
+
+	static const std::string preproof_predicate_name;
+
+private:
+	// Index a control rule if it is an expansion one. Must be called
+	// with _mutex locked.
+	void index(const Handle& ctrl_rule);
+
+	static bool is_preproof(const Handle& h);
+	static bool is_expansion(const Handle& h);
+
+	AtomSpace& _control_as;
+
+	// Map inference rule aliases (from the control atomspace) to
+	// their expansion control rules
+	std::map<Handle, HandleSet> _expansion_control_rules;
+
+	mutable std::mutex _mutex;
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_CONTROLRULEINDEX_H_
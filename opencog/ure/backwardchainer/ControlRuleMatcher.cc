@@ -0,0 +1,140 @@
+/*
+ * ControlRuleMatcher.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/atoms/base/Link.h>
+
+#include "ControlRuleMatcher.h"
+
+using namespace opencog;
+
+ControlRuleMatcher::ControlRuleMatcher(const Variables& variables,
+                                       const Handle& target_pattern,
+                                       const Handle& andbit_pattern,
+                                       const Handle& bitleaf_pattern,
+                                       const Handle& target)
+	: _variables(variables),
+	  _andbit_pattern(andbit_pattern),
+	  _bitleaf_pattern(bitleaf_pattern),
+	  _compiled(is_compilable(target_pattern) and
+	            is_compilable(andbit_pattern) and
+	            is_compilable(bitleaf_pattern)),
+	  _target_match(_compiled and match(target_pattern, target))
+{
+}
+
+bool ControlRuleMatcher::is_compiled() const
+{
+	return _compiled;
+}
+
+bool ControlRuleMatcher::is_active(const Handle& andbit,
+                                   const Handle& bitleaf) const
+{
+	return _target_match
+		and match(_andbit_pattern, andbit)
+		and match(_bitleaf_pattern, bitleaf);
+}
+
+bool ControlRuleMatcher::match(const Handle& pattern, const Handle& term) const
+{
+	HandleMap bindings;
+	return match(pattern, term, bindings);
+}
+
+bool ControlRuleMatcher::is_compilable(const Handle& pattern)
+{
+	Type t = pattern->get_type();
+	if (nameserver().isA(t, GLOB_NODE) or
+	    nameserver().isA(t, QUOTE_LINK) or
+	    nameserver().isA(t, UNQUOTE_LINK) or
+	    nameserver().isA(t, LOCAL_QUOTE_LINK) or
+	    nameserver().isA(t, SCOPE_LINK))
+		return false;
+	if (pattern->is_link())
+		for (const Handle& child : pattern->getOutgoingSet())
+			if (not is_compilable(child))
+				return false;
+	return true;
+}
+
+bool ControlRuleMatcher::match(const Handle& pattern, const Handle& term,
+                               HandleMap& bindings) const
+{
+	// Variable, check that its binding is consistent
+	if (_variables.varset.find(pattern) != _variables.varset.end()) {
+		auto it = bindings.find(pattern);
+		if (it != bindings.end())
+			return content_eq(it->second, term);
+		if (not _variables.is_type(pattern, term))
+			return false;
+		bindings[pattern] = term;
+		return true;
+	}
+
+	if (pattern->get_type() != term->get_type())
+		return false;
+
+	// Constant node
+	if (pattern->is_node())
+		return pattern->get_name() == term->get_name();
+
+	// Link
+	const HandleSeq& pouts = pattern->getOutgoingSet();
+	const HandleSeq& touts = term->getOutgoingSet();
+	if (pouts.size() != touts.size())
+		return false;
+
+	if (nameserver().isA(pattern->get_type(), UNORDERED_LINK)) {
+		std::vector<bool> used(touts.size(), false);
+		return match_unordered(pouts, touts, 0, used, bindings);
+	}
+
+	for (size_t i = 0; i < pouts.size(); i++)
+		if (not match(pouts[i], touts[i], bindings))
+			return false;
+	return true;
+}
+
+bool ControlRuleMatcher::match_unordered(const HandleSeq& pattern,
+                                         const HandleSeq& term,
+                                         size_t i, std::vector<bool>& used,
+                                         HandleMap& bindings) const
+{
+	if (i == pattern.size())
+		return true;
+
+	for (size_t j = 0; j < term.size(); j++) {
+		if (used[j])
+			continue;
+
+		// Bind on a copy so that bindings can be reverted on failure
+		HandleMap jbindings(bindings);
+		if (match(pattern[i], term[j], jbindings)) {
+			used[j] = true;
+			if (match_unordered(pattern, term, i + 1, used, jbindings)) {
+				bindings = jbindings;
+				return true;
+			}
+			used[j] = false;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,108 @@
+/*
+ * ControlRuleMatcher.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_CONTROLRULEMATCHER_H_
+#define _OPENCOG_CONTROLRULEMATCHER_H_
+
+#include <opencog/atoms/core/Variables.h>
+
+namespace opencog
+{
+
+/**
+ * In-memory matcher of the antecedent of an expansion control rule,
+ * compiled once from its variables and its target, and-BIT and
+ * BIT-leaf patterns, see ControlPolicy::is_control_rule_active.
+ *
+ * Matching is purely structural, variables are bound consistently
+ * within each pattern and checked against their type restrictions,
+ * unordered links are matched up to permutation, and no atomspace is
+ * involved. Patterns containing constructs requiring the full
+ * pattern matcher (quotations, globs, scopes, etc) are not compiled,
+ * in which case is_compiled returns false and the caller is expected
+ * to fall back on the pattern matcher.
+ */
+class ControlRuleMatcher
+{
+public:
+	/**
+	 * Compile the matcher.
+	 *
+	 * @param variables       Variables of the control rule
+	 * @param target_pattern  Target pattern of the control rule
+	 * @param andbit_pattern  Input and-BIT pattern of the control rule
+	 * @param bitleaf_pattern Input BIT-leaf pattern of the control rule
+	 * @param target          Actual target of the backward chainer
+	 */
+	ControlRuleMatcher(const Variables& variables,
+	                   const Handle& target_pattern,
+	                   const Handle& andbit_pattern,
+	                   const Handle& bitleaf_pattern,
+	                   const Handle& target);
+
+	/**
+	 * Return true iff the patterns could be compiled.
+	 */
+	bool is_compiled() const;
+
+	/**
+	 * Return true iff the control rule is active for the given and-BIT
+	 * (its FCS wrapped in a DontExecLink) and BIT-leaf, that is each
+	 * pattern matches its actual counterpart.
+	 *
+	 * Thread safe.
+	 */
+	bool is_active(const Handle& andbit, const Handle& bitleaf) const;
+
+	/**
+	 * Return true iff pattern matches term, starting with no binding.
+	 */
+	bool match(const Handle& pattern, const Handle& term) const;
+
+	/**
+	 * Return true iff the pattern can be matched by this matcher.
+	 */
+	static bool is_compilable(const Handle& pattern);
+
+private:
+	bool match(const Handle& pattern, const Handle& term,
+	           HandleMap& bindings) const;
+
+	// Match the outgoings of pattern and term, up to permutation,
+	// starting from the i-th outgoing of pattern, given the outgoings
+	// of term already used.
+	bool match_unordered(const HandleSeq& pattern, const HandleSeq& term,
+	                     size_t i, std::vector<bool>& used,
+	                     HandleMap& bindings) const;
+
+	Variables _variables;
+	Handle _andbit_pattern;
+	Handle _bitleaf_pattern;
+
+	bool _compiled;
+
+	// Whether the target pattern matches the actual target, which is
+	// fixed for the lifetime of the matcher.
+	bool _target_match;
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_CONTROLRULEMATCHER_H_
@@ -0,0 +1,231 @@
+/*
+ * FCSBatch.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <boost/range/algorithm/find.hpp>
+#include <boost/range/algorithm/remove_if.hpp>
+#include <boost/range/algorithm_ext/erase.hpp>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/atoms/core/FindUtils.h>
+#include <opencog/atoms/core/ScopeLink.h>
+#include <opencog/atoms/core/TypeUtils.h>
+#include <opencog/atoms/pattern/BindLink.h>
+
+#include "FCSBatch.h"
+#include "BIT.h"
+#include "../URELogger.h"
+
+using namespace opencog;
+
+void FCSBatch::insert(const Handle& fcs)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (boost::find(_fcss, fcs) == _fcss.end())
+		_fcss.push_back(fcs);
+}
+
+size_t FCSBatch::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _fcss.size();
+}
+
+std::vector<HandleSeq> FCSBatch::pop_groups()
+{
+	HandleSeq fcss;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		std::swap(fcss, _fcss);
+	}
+
+	std::vector<HandleSeq> groups;
+	std::vector<bool> grouped(fcss.size(), false);
+	for (size_t i = 0; i < fcss.size(); i++) {
+		if (grouped[i])
+			continue;
+
+		HandleSeq group{fcss[i]};
+		grouped[i] = true;
+		HandleSeq common;
+		if (is_mergeable(fcss[i]))
+			common = AndBIT::get_present_clauses(BindLinkCast(fcss[i])->get_body());
+		for (size_t j = i + 1; j < fcss.size() and not common.empty(); j++) {
+			if (grouped[j] or not is_mergeable(fcss[j]))
+				continue;
+			HandleSeq clauses = AndBIT::get_present_clauses(BindLinkCast(fcss[j])->get_body());
+			HandleSeq inter(common);
+			boost::remove_erase_if(inter, [&](const Handle& c) {
+					return boost::find(clauses, c) == clauses.end(); });
+			if (inter.empty())
+				continue;
+			common = inter;
+			group.push_back(fcss[j]);
+			grouped[j] = true;
+		}
+		groups.push_back(group);
+	}
+	return groups;
+}
+
+void FCSBatch::execute(const HandleSeq& group, AtomSpace& as,
+                       const ResultsCallback& cb)
+{
+	if (1 < group.size()) {
+		try {
+			merged_execute(group, as, cb);
+			return;
+		} catch (...) {
+			LAZY_URE_LOG_DEBUG << "Cannot merge the execution of FCS group, "
+			                   << "execute them individually";
+		}
+	}
+	for (const Handle& fcs : group)
+		execute(fcs, as, cb);
+}
+
+void FCSBatch::execute(const Handle& fcs, AtomSpace& as,
+                       const ResultsCallback& cb)
+{
+	// Temporary atomspace to not pollute as with intermediary
+	// results, see BackwardChainer::fulfill_fcs for more explanation.
+	AtomSpacePtr fcs_as(createAtomSpace(&as));
+	fcs_as->clear_copy_on_write();
+
+	// Wrap in a try/catch in case the pattern matcher can't handle
+	// it.
+	try {
+		Handle hresult = HandleCast(fcs->execute(fcs_as.get()));
+		cb(fcs, hresult->getOutgoingSet());
+	} catch (...) {}
+}
+
+HandleSeq FCSBatch::common_present_clauses(const HandleSeq& group)
+{
+	if (group.empty())
+		return {};
+
+	HandleSeq common = AndBIT::get_present_clauses(BindLinkCast(group[0])->get_body());
+	for (size_t i = 1; i < group.size(); i++) {
+		HandleSeq clauses = AndBIT::get_present_clauses(BindLinkCast(group[i])->get_body());
+		boost::remove_erase_if(common, [&](const Handle& c) {
+				return boost::find(clauses, c) == clauses.end(); });
+	}
+	return common;
+}
+
+bool FCSBatch::is_mergeable(const Handle& fcs)
+{
+	Handle body = BindLinkCast(fcs)->get_body();
+	HandleSeq clauses = AndBIT::get_present_clauses(body);
+	HandleSeq virtual_clauses = AndBIT::get_virtual_clauses(body);
+	clauses.insert(clauses.end(), virtual_clauses.begin(), virtual_clauses.end());
+	for (const Handle& clause : clauses)
+		if (nameserver().isA(clause->get_type(), VARIABLE_NODE) or
+		    contains_atomtype(clause, MEMBER_LINK))
+			return false;
+	return true;
+}
+
+void FCSBatch::merged_execute(const HandleSeq& group, AtomSpace& as,
+                              const ResultsCallback& cb)
+{
+	for (const Handle& fcs : group)
+		if (not is_mergeable(fcs))
+			throw RuntimeException(TRACE_INFO, "FCS may match the anchor");
+
+	HandleSeq common = common_present_clauses(group);
+	if (common.empty())
+		throw RuntimeException(TRACE_INFO, "No common present clauses");
+
+	// Temporary atomspace holding the groundings of the common
+	// clauses.
+	AtomSpacePtr batch_as(createAtomSpace(&as));
+	batch_as->clear_copy_on_write();
+
+	// The variables of the common clauses must be declared alike in
+	// all FCSs, otherwise their groundings cannot be shared.
+	Handle common_body = batch_as->add_link(PRESENT_LINK, HandleSeq(common));
+	Handle vardecl;
+	for (const Handle& fcs : group) {
+		Handle fcs_vardecl = BindLinkCast(fcs)->get_variables().get_vardecl();
+		Handle common_vardecl = filter_vardecl(fcs_vardecl, common_body);
+		if (not common_vardecl)
+			throw RuntimeException(TRACE_INFO, "Common clauses are constant");
+		if (not vardecl)
+			vardecl = common_vardecl;
+		else if (not content_eq(vardecl, common_vardecl))
+			throw RuntimeException(TRACE_INFO, "Inconsistent variable declarations");
+	}
+
+	// Match the common clauses once
+	Handle gl = batch_as->add_link(GET_LINK, vardecl, common_body);
+	Handle groundings = HandleCast(gl->execute(batch_as.get()));
+	LAZY_URE_LOG_DEBUG << "Merged execution of " << group.size()
+	                   << " FCSs over common clauses:" << std::endl << common
+	                   << "with " << groundings->get_arity() << " groundings";
+
+	// No grounding, thus no FCS of the group can be satisfied
+	if (groundings->get_arity() == 0)
+		return;
+
+	// Store the groundings as members of an anchor, in the order of
+	// the variables of the GetLink.
+	const HandleSeq& vars = ScopeLinkCast(gl)->get_variables().varseq;
+	Handle anchor = batch_as->add_node(ANCHOR_NODE, "URE:BC:fcs-batch");
+	for (const Handle& grounding : groundings->getOutgoingSet())
+		batch_as->add_link(MEMBER_LINK, grounding, anchor);
+	Handle var_tuple = vars.size() == 1 ? vars[0]
+		: batch_as->add_link(LIST_LINK, HandleSeq(vars));
+	Handle member = batch_as->add_link(MEMBER_LINK, var_tuple, anchor);
+
+	// Execute the tails, each in its own atomspace so that the FCSs
+	// of the group don't see each other's intermediary results.
+	for (const Handle& fcs : group) {
+		AtomSpacePtr fcs_as(createAtomSpace(batch_as.get()));
+		fcs_as->clear_copy_on_write();
+		try {
+			Handle tail = rewrite_fcs(fcs, common, member, *fcs_as);
+			Handle hresult = HandleCast(tail->execute(fcs_as.get()));
+			cb(fcs, hresult->getOutgoingSet());
+		} catch (...) {}
+	}
+}
+
+Handle FCSBatch::rewrite_fcs(const Handle& fcs, const HandleSeq& common,
+                             const Handle& member, AtomSpace& as)
+{
+	BindLinkPtr fcs_bl(BindLinkCast(fcs));
+	Handle body = fcs_bl->get_body();
+
+	// Build the new body like AndBIT::mk_pattern does
+	HandleSeq present = AndBIT::get_present_clauses(body);
+	boost::remove_erase_if(present, [&](const Handle& c) {
+			return boost::find(common, c) != common.end(); });
+	present.push_back(member);
+	HandleSeq clauses = AndBIT::get_virtual_clauses(body);
+	clauses.insert(clauses.begin(), as.add_link(PRESENT_LINK, std::move(present)));
+	Handle nbody = as.add_link(AND_LINK, std::move(clauses));
+
+	// The body is the penultimate outgoing of the BindLink
+	HandleSeq outgoings(fcs->getOutgoingSet());
+	outgoings[outgoings.size() - 2] = nbody;
+	return as.add_link(BIND_LINK, std::move(outgoings));
+}
@@ -0,0 +1,128 @@
+/*
+ * FCSBatch.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_FCSBATCH_H_
+#define _OPENCOG_FCSBATCH_H_
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+namespace opencog
+{
+
+/**
+ * Batch of forward chaining strategies (FCS) pending fulfillment.
+ *
+ * And-BITs produced by expanding the same parent only differ by the
+ * sub-tree replacing the expanded leaf, thus their FCS patterns tend
+ * to share most of their present clauses. Rather than running each
+ * FCS on its own, the FCSs of a batch are grouped by common present
+ * clauses, then for each group the join over the common clauses is
+ * evaluated once, and its groundings are fed to the remaining clauses
+ * of each FCS of the group, like a multi-query optimizer would do.
+ */
+class FCSBatch
+{
+public:
+	// Called with each FCS of a group and its results, while the
+	// atomspace holding the results is still alive.
+	typedef std::function<void(const Handle&, const HandleSeq&)> ResultsCallback;
+
+	/**
+	 * Add an FCS to the batch, if not already there. Thread safe.
+	 */
+	void insert(const Handle& fcs);
+
+	/**
+	 * Return the number of FCSs in the batch. Thread safe.
+	 */
+	size_t size() const;
+
+	/**
+	 * Empty the batch and return its FCSs, partitioned into groups
+	 * sharing at least one present clause. Thread safe.
+	 *
+	 * Grouping is greedy, the first FCS not yet grouped is used as
+	 * seed and the following FCSs are added to its group as long as
+	 * the set of present clauses common to the group remains
+	 * non-empty. FCSs that are not mergeable, see is_mergeable, are
+	 * left in their own groups.
+	 */
+	std::vector<HandleSeq> pop_groups();
+
+	/**
+	 * Execute a group of FCSs, as produced by pop_groups, in a child
+	 * atomspace of as, and pass the results of each FCS to cb.
+	 *
+	 * The common present clauses are matched once, their groundings
+	 * are then stored as MemberLinks to an anchor, which replace the
+	 * common clauses in each FCS. If the common clauses have no
+	 * grounding, no FCS of the group is executed at all. If the
+	 * group cannot be merged (single FCS, FCS not mergeable, no
+	 * common clause, inconsistent variable declarations, or failure
+	 * of the pattern matcher) its FCSs are executed individually.
+	 */
+	static void execute(const HandleSeq& group, AtomSpace& as,
+	                    const ResultsCallback& cb);
+
+	/**
+	 * Execute a single FCS in a child atomspace of as and pass its
+	 * results to cb. Errors are ignored, in case the pattern matcher
+	 * can't handle the FCS.
+	 */
+	static void execute(const Handle& fcs, AtomSpace& as,
+	                    const ResultsCallback& cb);
+
+	/**
+	 * Return the present clauses shared by all FCSs of a group.
+	 */
+	static HandleSeq common_present_clauses(const HandleSeq& group);
+
+	/**
+	 * Return false if some clause of the FCS may match the MemberLinks
+	 * to the anchor holding the groundings of a merged execution,
+	 * that is if it is a variable or contains a MemberLink, as its
+	 * results would then be spurious.
+	 */
+	static bool is_mergeable(const Handle& fcs);
+
+private:
+	// Execute a group as described above, throw if the group
+	// cannot be merged.
+	static void merged_execute(const HandleSeq& group, AtomSpace& as,
+	                           const ResultsCallback& cb);
+
+	// Replace the clauses of the body of fcs, present in common, by
+	// the given membership clause, and add the result to as.
+	static Handle rewrite_fcs(const Handle& fcs, const HandleSeq& common,
+	                          const Handle& member, AtomSpace& as);
+
+	// FCSs pending fulfillment, in insertion order
+	HandleSeq _fcss;
+
+	mutable std::mutex _mutex;
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_FCSBATCH_H_
@@ -0,0 +1,96 @@
+/*
+ * FulfillmentQueue.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <opencog/util/oc_assert.h>
+
+#include "FulfillmentQueue.h"
+
+using namespace opencog;
+
+FulfillmentQueue::FulfillmentQueue(unsigned jobs, size_t capacity)
+	: _capacity(std::max(capacity, (size_t)1)), _running(0), _stop(false)
+{
+	OC_ASSERT(0 < jobs, "There must be at least one fulfillment job");
+	for (unsigned i = 0; i < jobs; i++)
+		_workers.emplace_back(&FulfillmentQueue::work, this);
+}
+
+FulfillmentQueue::~FulfillmentQueue()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_not_empty.notify_all();
+	for (std::thread& worker : _workers)
+		worker.join();
+}
+
+void FulfillmentQueue::push(const Job& job)
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_not_full.wait(lock, [&]() { return _jobs.size() < _capacity; });
+		_jobs.push(job);
+	}
+	_not_empty.notify_one();
+}
+
+void FulfillmentQueue::wait()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_idle.wait(lock, [&]() { return _jobs.empty() and _running == 0; });
+}
+
+size_t FulfillmentQueue::size() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _jobs.size();
+}
+
+void FulfillmentQueue::work()
+{
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_not_empty.wait(lock, [&]() { return _stop or not _jobs.empty(); });
+			if (_jobs.empty())
+				return;         // Stopped and nothing left to do
+			job = std::move(_jobs.front());
+			_jobs.pop();
+			_running++;
+		}
+		_not_full.notify_one();
+
+		// Jobs are not supposed to throw, but if one does, don't let
+		// it kill the worker.
+		try {
+			job();
+		} catch (...) {}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_running--;
+		}
+		_idle.notify_all();
+	}
+}
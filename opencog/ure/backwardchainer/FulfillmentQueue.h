@@ -0,0 +1,99 @@
+/*
+ * FulfillmentQueue.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_FULFILLMENTQUEUE_H_
+#define _OPENCOG_FULFILLMENTQUEUE_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace opencog
+{
+
+/**
+ * Bounded queue of fulfillment jobs served by worker threads.
+ *
+ * This allows the backward chainer to keep expanding the BIT while
+ * the forward chaining strategies of the previously produced and-BITs
+ * are being executed by the pattern matcher. When the queue is full
+ * push blocks, so that expansion does not get too far ahead of
+ * fulfillment.
+ */
+class FulfillmentQueue
+{
+public:
+	typedef std::function<void()> Job;
+
+	/**
+	 * Start the worker threads.
+	 *
+	 * @param jobs      Number of worker threads
+	 * @param capacity  Maximum number of pending jobs
+	 */
+	FulfillmentQueue(unsigned jobs, size_t capacity);
+
+	/**
+	 * Complete all pending jobs, then stop the worker threads.
+	 */
+	~FulfillmentQueue();
+
+	/**
+	 * Add a job to the queue. Block while the queue is full.
+	 */
+	void push(const Job& job);
+
+	/**
+	 * Block till all pending jobs have been completed.
+	 */
+	void wait();
+
+	/**
+	 * Return the number of pending jobs, not counting the ones being
+	 * processed.
+	 */
+	size_t size() const;
+
+private:
+	// Worker loop, pop jobs and run them till stopped
+	void work();
+
+	std::vector<std::thread> _workers;
+	std::queue<Job> _jobs;
+	size_t _capacity;
+
+	// Number of jobs being currently processed
+	unsigned _running;
+
+	// Whether the workers should stop once the queue is empty
+	bool _stop;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _not_empty;
+	std::condition_variable _not_full;
+	std::condition_variable _idle;
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_FULFILLMENTQUEUE_H_
@@ -0,0 +1,170 @@
+/*
+ * TargetDecomposer.cc
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <boost/range/algorithm/find.hpp>
+#include <boost/range/algorithm/sort.hpp>
+
+#include <opencog/atoms/core/FindUtils.h>
+#include <opencog/atoms/core/ScopeLink.h>
+#include <opencog/atoms/core/TypeUtils.h>
+
+#include "TargetDecomposer.h"
+#include "../URELogger.h"
+
+using namespace opencog;
+
+std::vector<HandleSeq> TargetDecomposer::components(const HandleSeq& conjuncts,
+                                                    const HandleSet& varset)
+{
+	std::vector<HandleSet> conjunct_vars;
+	for (const Handle& conjunct : conjuncts)
+		conjunct_vars.push_back(variables(conjunct, varset));
+
+	// Traverse the variable sharing graph, component by component
+	std::vector<HandleSeq> comps;
+	std::vector<bool> visited(conjuncts.size(), false);
+	for (size_t i = 0; i < conjuncts.size(); i++) {
+		if (visited[i])
+			continue;
+		std::vector<size_t> comp{i};
+		visited[i] = true;
+		for (size_t k = 0; k < comp.size(); k++) {
+			for (size_t j = 0; j < conjuncts.size(); j++) {
+				if (not visited[j] and
+				    intersect(conjunct_vars[comp[k]], conjunct_vars[j])) {
+					visited[j] = true;
+					comp.push_back(j);
+				}
+			}
+		}
+		// Preserve the order of the conjuncts
+		boost::sort(comp);
+		HandleSeq hcomp;
+		for (size_t j : comp)
+			hcomp.push_back(conjuncts[j]);
+		comps.push_back(hcomp);
+	}
+	return comps;
+}
+
+HandleSeq TargetDecomposer::order(const HandleSeq& component,
+                                  const ClausePlan& plan,
+                                  const HandleSet& varset)
+{
+	auto estimate = [&](const Handle& conjunct) {
+		auto it = boost::find(plan.clauses, conjunct);
+		return it == plan.clauses.end() ? ClausePlan::unknown
+			: plan.estimates[std::distance(plan.clauses.begin(), it)];
+	};
+
+	HandleSeq ordered;
+	HandleSeq remaining(component);
+	HandleSet covered;
+	while (not remaining.empty()) {
+		// Select the most selective conjunct connected to the ordered
+		// ones, or simply the most selective one to start with.
+		auto best = remaining.end();
+		for (auto it = remaining.begin(); it != remaining.end(); ++it) {
+			if (not ordered.empty() and
+			    not intersect(covered, variables(*it, varset)))
+				continue;
+			if (best == remaining.end() or estimate(*it) < estimate(*best))
+				best = it;
+		}
+		// Cannot happen within a component, but just in case
+		if (best == remaining.end())
+			best = remaining.begin();
+
+		HandleSet best_vars = variables(*best, varset);
+		covered.insert(best_vars.begin(), best_vars.end());
+		ordered.push_back(*best);
+		remaining.erase(best);
+	}
+	return ordered;
+}
+
+HandleSeq TargetDecomposer::instantiate(const Handle& conjunct,
+                                        const HandleSeq& prefix,
+                                        const Handle& vardecl,
+                                        AtomSpace& as,
+                                        size_t max)
+{
+	Handle prefix_body = as.add_link(PRESENT_LINK, HandleSeq(prefix));
+	Handle prefix_vardecl = filter_vardecl(vardecl, prefix_body);
+	if (not prefix_vardecl)
+		return {conjunct};
+
+	Handle gl = as.add_link(GET_LINK, prefix_vardecl, prefix_body);
+	const Variables& prefix_vars = ScopeLinkCast(gl)->get_variables();
+	HandleSet conjunct_vars = get_free_variables(conjunct);
+	if (not intersect(HandleSet(prefix_vars.varseq.begin(),
+	                            prefix_vars.varseq.end()), conjunct_vars))
+		return {conjunct};
+
+	// Substitute the variables of the prefix by their groundings
+	Handle groundings = HandleCast(gl->execute(&as));
+	HandleSeq instances;
+	HandleSet seen;
+	bool truncated = false;
+	for (const Handle& grounding : groundings->getOutgoingSet()) {
+		HandleSeq args = prefix_vars.varseq.size() == 1 ? HandleSeq{grounding}
+			: grounding->getOutgoingSet();
+		Handle instance =
+			as.add_atom(prefix_vars.substitute_nocheck(conjunct, args));
+		if (seen.insert(instance).second) {
+			if (max <= instances.size()) {
+				truncated = true;
+				break;
+			}
+			instances.push_back(instance);
+		}
+	}
+
+	if (truncated)
+		LAZY_URE_LOG_WARN << "Only the first " << max << " instances of conjunct:"
+		                  << std::endl << oc_to_string(conjunct)
+		                  << "are solved, see URE:BC:maximum-subtarget-instances";
+
+	LAZY_URE_LOG_DEBUG << "Instantiated conjunct:" << std::endl
+	                   << oc_to_string(conjunct)
+	                   << "with " << groundings->get_arity()
+	                   << " groundings of prefix:" << std::endl
+	                   << oc_to_string(prefix)
+	                   << "into " << instances.size() << " instances";
+	return instances;
+}
+
+HandleSet TargetDecomposer::variables(const Handle& conjunct,
+                                      const HandleSet& varset)
+{
+	HandleSet vars;
+	for (const Handle& var : get_free_variables(conjunct))
+		if (varset.find(var) != varset.end())
+			vars.insert(var);
+	return vars;
+}
+
+bool TargetDecomposer::intersect(const HandleSet& lhs, const HandleSet& rhs)
+{
+	for (const Handle& h : lhs)
+		if (rhs.find(h) != rhs.end())
+			return true;
+	return false;
+}
@@ -0,0 +1,92 @@
+/*
+ * TargetDecomposer.h
+ *
+ * Copyright (C) 2020 SingularityNET Foundation
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#ifndef _OPENCOG_TARGETDECOMPOSER_H_
+#define _OPENCOG_TARGETDECOMPOSER_H_
+
+#include <vector>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "../ClausePlanner.h"
+
+namespace opencog
+{
+
+/**
+ * Decompose a conjunctive target into sub-targets that can be solved
+ * by independent backward chainers.
+ *
+ * The conjuncts of the target are first partitioned into connected
+ * components, two conjuncts being connected if they share a
+ * variable. Components have no variables in common, they can thus
+ * be solved concurrently. Then, within a component, conjuncts are
+ * ordered by dependency, starting with the most selective one
+ * according to the clause planner, followed by the most selective
+ * ones connected to the conjuncts already ordered, so that the
+ * groundings of the solved prefix can be used to instantiate, and
+ * thus narrow down, the next conjunct.
+ */
+class TargetDecomposer
+{
+public:
+	/**
+	 * Partition the conjuncts into connected components. Two
+	 * conjuncts are connected if they share at least one variable of
+	 * varset. The order of the conjuncts is preserved within each
+	 * component.
+	 */
+	static std::vector<HandleSeq> components(const HandleSeq& conjuncts,
+	                                         const HandleSet& varset);
+
+	/**
+	 * Order the conjuncts of a component by dependency, as described
+	 * above, given the plan of the whole target.
+	 */
+	static HandleSeq order(const HandleSeq& component,
+	                       const ClausePlan& plan,
+	                       const HandleSet& varset);
+
+	/**
+	 * Instantiate the conjunct with the groundings in as of the
+	 * variables of vardecl it shares with the solved prefix.
+	 * Instances are added to as and at most max of them are
+	 * returned, a warning being logged if some are left out. If the
+	 * conjunct shares no variable with the prefix, the conjunct
+	 * itself is returned.
+	 */
+	static HandleSeq instantiate(const Handle& conjunct,
+	                             const HandleSeq& prefix,
+	                             const Handle& vardecl,
+	                             AtomSpace& as,
+	                             size_t max);
+
+private:
+	// Return the variables of varset present in the conjunct
+	static HandleSet variables(const Handle& conjunct,
+	                           const HandleSet& varset);
+
+	// Return true iff both sets have at least one element in common
+	static bool intersect(const HandleSet& lhs, const HandleSet& rhs);
+};
+
+} // ~namespace opencog
+
+#endif // _OPENCOG_TARGETDECOMPOSER_H_
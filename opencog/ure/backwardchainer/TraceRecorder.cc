@@ -21,6 +21,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <cstdint>
+
 #include "TraceRecorder.h"
 #include <opencog/util/algorithm.h>
 
@@ -31,7 +34,13 @@ const std::string TraceRecorder::andbit_predicate_name = "URE:BC:and-BIT";
 const std::string TraceRecorder::expand_andbit_schema_name = "URE:BC:expand-and-BIT";
 const std::string TraceRecorder::proof_predicate_name = "URE:BC:proof-of";
 
-TraceRecorder::TraceRecorder(AtomSpace* tr_as) : _trace_as(tr_as) {
+TraceRecorder::TraceRecorder(AtomSpace* tr_as,
+                             std::shared_ptr<TraceFile> trace_file)
+	: _trace_as(tr_as), _trace_file(trace_file), _trace_run(0)
+{
+	if (_trace_file)
+		_trace_run = _trace_file->run(TraceFile::BC);
+
 	if (_trace_as) {
 		_target_predicate =
 			_trace_as->add_node(PREDICATE_NODE, std::move(std::string(target_predicate_name)));
@@ -44,39 +53,130 @@ TraceRecorder::TraceRecorder(AtomSpace* tr_as) : _trace_as(tr_as) {
 	}
 }
 
+TraceRecorder::~TraceRecorder()
+{
+	if (_trace_file)
+		_trace_file->flush();
+}
+
 HandleSeqSet TraceRecorder::traces()
 {
 	HandleSeqSet trs;
-	for (const Handle& fcs_proof : get_fcs_proofs())
-		set_union_modify(trs, traces(fcs_proof));
+	TraceMemo memo;
+	TraceVisiting visiting;
+	for (const Handle& fcs_proof : get_fcs_proofs()) {
+		size_t low;
+		set_union_modify(trs, memo_traces(fcs_proof, memo, visiting, low));
+		// Forget its traces if cut short by a cycle through it
+		if (low == 0)
+			memo.erase(fcs_proof);
+	}
 	return trs;
 }
 
 HandleSeqSet TraceRecorder::traces(const Handle& fcs)
 {
-	HandleSet expansion_sources(get_expansion_sources(fcs));
+	TraceMemo memo;
+	TraceVisiting visiting;
+	size_t low;
+	return memo_traces(fcs, memo, visiting, low);
+}
+
+bool TraceRecorder::traces(const TraceCallback& callback)
+{
+	for (const Handle& fcs_proof : get_fcs_proofs())
+		if (not traces(fcs_proof, callback))
+			return false;
+	return true;
+}
+
+bool TraceRecorder::traces(const Handle& fcs, const TraceCallback& callback)
+{
+	HandleSeq rpath;
+	HandleSet visiting;
+	return stream_traces(fcs, rpath, visiting, callback);
+}
+
+const HandleSeqSet& TraceRecorder::memo_traces(const Handle& fcs,
+                                               TraceMemo& memo,
+                                               TraceVisiting& visiting,
+                                               size_t& low)
+{
+	size_t depth = visiting.size();
+	low = SIZE_MAX;
+	auto it = memo.find(fcs);
+	if (it != memo.end())
+		return it->second;
 
 	// Unwrap DontExecLink around the fcs
 	Handle exec_fcs = fcs->getOutgoingAtom(0);
 
-	// Base case
-	if (expansion_sources.empty())
-		return HandleSeqSet{{exec_fcs}};
-
 	// Recursive case
 	HandleSeqSet trs;
-	for (const Handle& h : expansion_sources) {
-		for (HandleSeq hs : traces(h)) {
-			hs.push_back(exec_fcs);
-			trs.insert(hs);
+	visiting[fcs] = depth;
+	for (const Handle& h : get_expansion_sources(fcs)) {
+		auto vit = visiting.find(h);
+		if (vit != visiting.end()) {
+			if (h != fcs)
+				low = std::min(low, vit->second);
+			continue;
+		}
+		size_t h_low;
+		for (const HandleSeq& hs : memo_traces(h, memo, visiting, h_low)) {
+			HandleSeq tr(hs);
+			tr.push_back(exec_fcs);
+			trs.insert(std::move(tr));
 		}
+		// The traces of h were cut short by a cycle through h or its
+		// ancestors, they would differ if h were reached by another
+		// path, thus must not be reused.
+		if (h_low <= depth + 1)
+			memo.erase(h);
+		if (h_low <= depth)
+			low = std::min(low, h_low);
 	}
-	return trs;
+	visiting.erase(fcs);
+
+	// Base case
+	if (trs.empty())
+		trs.insert(HandleSeq{exec_fcs});
+
+	return memo.emplace(fcs, std::move(trs)).first->second;
+}
+
+bool TraceRecorder::stream_traces(const Handle& fcs, HandleSeq& rpath,
+                                  HandleSet& visiting,
+                                  const TraceCallback& callback)
+{
+	// Unwrap DontExecLink around the fcs
+	rpath.push_back(fcs->getOutgoingAtom(0));
+	visiting.insert(fcs);
+
+	// Recursive case
+	bool is_source = true, go_on = true;
+	for (const Handle& h : get_expansion_sources(fcs)) {
+		if (contains(visiting, h))
+			continue;
+		is_source = false;
+		go_on = stream_traces(h, rpath, visiting, callback);
+		if (not go_on)
+			break;
+	}
+
+	// Base case
+	if (is_source)
+		go_on = callback(HandleSeq(rpath.rbegin(), rpath.rend()));
+
+	visiting.erase(fcs);
+	rpath.pop_back();
+	return go_on;
 }
 
 void TraceRecorder::target(const Handle& target)
 {
 	add_evaluation(_target_predicate, target, TruthValue::TRUE_TV());
+	if (_trace_file)
+		_trace_file->bc_target(_trace_run, target);
 }
 
 void TraceRecorder::andbit(const AndBIT& andbit)
@@ -84,6 +184,8 @@ void TraceRecorder::andbit(const AndBIT& andbit)
 	add_evaluation(_andbit_predicate,
 	               dont_exec(andbit.fcs),
 	               TruthValue::TRUE_TV());
+	if (_trace_file)
+		_trace_file->bc_andbit(_trace_run, andbit.fcs);
 }
 
 void TraceRecorder::expansion(const Handle& andbit_fcs, const Handle& bitleaf_body,
@@ -93,6 +195,9 @@ void TraceRecorder::expansion(const Handle& andbit_fcs, const Handle& bitleaf_bo
 	              dont_exec(andbit_fcs), bitleaf_body,
 	              dont_exec(rule.get_alias()),
 	              dont_exec(new_andbit.fcs), TruthValue::TRUE_TV());
+	if (_trace_file)
+		_trace_file->bc_expansion(_trace_run, andbit_fcs, bitleaf_body,
+		                          rule.get_alias(), new_andbit.fcs);
 }
 
 void TraceRecorder::proof(const Handle& andbit_fcs, const Handle& target_result)
@@ -100,6 +205,8 @@ void TraceRecorder::proof(const Handle& andbit_fcs, const Handle& target_result)
 	add_evaluation(_proof_predicate,
 	               dont_exec(andbit_fcs), target_result,
 	               target_result->getTruthValue());
+	if (_trace_file)
+		_trace_file->bc_proof(_trace_run, andbit_fcs, target_result);
 }
 
 Handle TraceRecorder::dont_exec(const Handle& h)
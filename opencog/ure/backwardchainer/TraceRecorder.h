@@ -23,10 +23,14 @@
 #ifndef _OPENCOG_TRACERECORDER_H_
 #define _OPENCOG_TRACERECORDER_H_
 
+#include <functional>
+#include <unordered_map>
+
 #include <opencog/atomspace/AtomSpace.h>
 
 #include "BIT.h"
 #include "../Rule.h"
+#include "../TraceFile.h"
 
 namespace opencog
 {
@@ -39,7 +43,14 @@ public:
 	static const std::string expand_andbit_schema_name;
 	static const std::string proof_predicate_name;
 
-	TraceRecorder(AtomSpace* tr_as);
+	// If trace_file is provided, the records are also written there,
+	// see TraceFile.
+	TraceRecorder(AtomSpace* tr_as,
+	              std::shared_ptr<TraceFile> trace_file = nullptr);
+	~TraceRecorder();
+
+	// Receive a trace, return false to stop the enumeration
+	typedef std::function<bool(const HandleSeq&)> TraceCallback;
 
 	// Return the traces of fcs leading to the recorded proofs
 	HandleSeqSet traces();
@@ -47,8 +58,20 @@ public:
 	// Return traces leading to the given FCS. A trace is a sequence
 	// of Handles, each representing a FCS and chained by
 	// ExecutionLinks as recorded in the expansion method.
+	//
+	// The expansions form a DAG, the traces of each FCS are computed
+	// once and shared by all the traces going through it, rather than
+	// recomputed for each path leading to it.
 	HandleSeqSet traces(const Handle& fcs);
 
+	// Streaming variants of the above. Pass the traces one at a time
+	// to callback, by depth-first traversal of the expansions, so
+	// that memory is bounded by the depth of the DAG rather than the
+	// number of traces, which may be exponential in it. Return false
+	// if callback stopped the enumeration.
+	bool traces(const TraceCallback& callback);
+	bool traces(const Handle& fcs, const TraceCallback& callback);
+
 	// Record that an atom is a target
 	//
 	// Evaluation (stv 1 1)
@@ -98,6 +121,8 @@ public:
 
 private:
 	AtomSpace* _trace_as;
+	std::shared_ptr<TraceFile> _trace_file;
+	uint64_t _trace_run;
 
 	Handle _target_predicate, _andbit_predicate, _expand_andbit_schema,
 		_proof_predicate;
@@ -154,6 +179,27 @@ private:
 	                      const Handle& arg1, const Handle& arg2,
 	                      TruthValuePtr tv);
 
+	typedef std::unordered_map<Handle, HandleSeqSet> TraceMemo;
+
+	// The fcs being traversed, and their depths
+	typedef std::unordered_map<Handle, size_t> TraceVisiting;
+
+	// Return the traces leading to fcs, memoized in memo. Sources
+	// in visiting are ignored so that a cycle, if any, does not lead
+	// to infinite recursion. Set low to the lowest depth of the fcs
+	// in visiting, other than fcs itself, at which its traces were
+	// thus cut, SIZE_MAX if none. If low is not greater than the
+	// depth of fcs, that is fcs is on a cycle, its traces depend on
+	// the path reaching it, and the caller must erase them from memo
+	// after use.
+	const HandleSeqSet& memo_traces(const Handle& fcs, TraceMemo& memo,
+	                                TraceVisiting& visiting, size_t& low);
+
+	// Pass the traces leading to fcs, suffixed by the reversed path
+	// rpath, to callback. Return false if callback returned false.
+	bool stream_traces(const Handle& fcs, HandleSeq& rpath,
+	                   HandleSet& visiting, const TraceCallback& callback);
+
 	// Given a fcs, return all fcs that expands to this fcs target.
 	HandleSet get_expansion_sources(const Handle& fcs_target);
 
@@ -26,15 +26,44 @@
 
 using namespace opencog;
 
+FCStat::FCStat(AtomSpace* trace_as, std::shared_ptr<TraceFile> trace_file)
+	: _record_limit(-1), _trace_as(trace_as), _trace_file(trace_file),
+	  _trace_run(0)
+{
+	if (_trace_file)
+		_trace_run = _trace_file->run(TraceFile::FC);
+}
+
+FCStat::~FCStat()
+{
+	if (_trace_file)
+		_trace_file->flush();
+}
+
 void FCStat::add_inference_record(unsigned iteration, Handle source,
                                   const Rule& rule,
                                   const HandleSet& product)
 {
+	HandleSeq new_products;
 	{
 		std::lock_guard<std::mutex> lock(_whole_mutex);
-		_inf_rec.emplace_back(source, rule, product);
+		for (const Handle& h : product) {
+			if (_products.insert(h).second) {
+				_product_seq.push_back(h);
+				new_products.push_back(h);
+			}
+		}
+
+		if (_record_limit != 0)
+			_inf_rec.emplace_back(source, rule, product);
+		while (0 <= _record_limit and (size_t)_record_limit < _inf_rec.size())
+			_inf_rec.pop_front();
 	}
 
+	if (_product_callback)
+		for (const Handle& h : new_products)
+			_product_callback(h);
+
 	if (_trace_as and not product.empty()) {
 		Handle schema = rule.get_alias();
 		Handle i = _trace_as->add_node(NUMBER_NODE, std::to_string(iteration + 1));
@@ -43,14 +72,49 @@ void FCStat::add_inference_record(unsigned iteration, Handle source,
 			_trace_as->add_link(EXECUTION_LINK, schema, inputs, output);
 		}
 	}
+
+	if (_trace_file and not product.empty())
+		_trace_file->fc_inference(_trace_run, iteration, rule.get_alias(),
+		                          source, product);
+}
+
+void FCStat::set_record_limit(int limit)
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	_record_limit = limit;
+	while (0 <= _record_limit and (size_t)_record_limit < _inf_rec.size())
+		_inf_rec.pop_front();
+}
+
+void FCStat::set_product_callback(const ProductCallback& cb)
+{
+	_product_callback = cb;
 }
 
 HandleSet FCStat::get_all_products() const
 {
 	std::lock_guard<std::mutex> lock(_whole_mutex);
-	HandleSet all;
-	for(const auto& ir : _inf_rec)
-		all.insert(ir.product.begin(),ir.product.end());
+	return _products;
+}
+
+HandleSeq FCStat::get_products() const
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	return _product_seq;
+}
 
-	return all;
+HandleSeq FCStat::get_new_products(size_t& cursor) const
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	HandleSeq new_products;
+	if (cursor < _product_seq.size())
+		new_products.assign(_product_seq.begin() + cursor, _product_seq.end());
+	cursor = _product_seq.size();
+	return new_products;
+}
+
+std::vector<InferenceRecord> FCStat::get_inference_records() const
+{
+	std::lock_guard<std::mutex> lock(_whole_mutex);
+	return std::vector<InferenceRecord>(_inf_rec.begin(), _inf_rec.end());
 }
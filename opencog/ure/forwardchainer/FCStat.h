@@ -24,10 +24,14 @@
 #ifndef _OPENCOG_FCSTAT_H_
 #define _OPENCOG_FCSTAT_H_
 
+#include <deque>
+#include <functional>
 #include <map>
+#include <mutex>
 
 #include <opencog/atoms/base/Handle.h>
 #include <opencog/ure/Rule.h>
+#include <opencog/ure/TraceFile.h>
 
 namespace opencog {
 
@@ -44,7 +48,12 @@ struct InferenceRecord
 class FCStat
 {
 public:
-	FCStat(AtomSpace* trace_as) : _trace_as(trace_as) {}
+	// Called on each new product, see set_product_callback
+	typedef std::function<void(const Handle&)> ProductCallback;
+
+	FCStat(AtomSpace* trace_as,
+	       std::shared_ptr<TraceFile> trace_file = nullptr);
+	~FCStat();
 
 	/**
 	 * Record the inference step into memory, as well as in the
@@ -63,15 +72,64 @@ public:
 	 * 2. <step> is NumberNode <#iteration>
 	 * 3. <source> is the source
 	 * 4. <product> is a SetLink <p1> ... <pn> where pi are the products
+	 *
+	 * If a trace file is provided, the inference is also recorded
+	 * there, see TraceFile::fc_inference.
+	 *
+	 * The products that have not been produced before are added to
+	 * the set of products, and passed to the product callback if
+	 * any. The record itself is only kept in memory within the limit
+	 * set by set_record_limit.
 	 */
 	void add_inference_record(unsigned iteration, Handle source,
 	                          const Rule& rule, const HandleSet& product);
+
+	/**
+	 * Set the maximum number of inference records kept in memory,
+	 * the oldest being discarded first. Negative means unbounded.
+	 */
+	void set_record_limit(int limit);
+
+	/**
+	 * Set a callback called on each new product, outside of any lock,
+	 * possibly concurrently if the inferences are performed by
+	 * multiple threads.
+	 */
+	void set_product_callback(const ProductCallback& cb);
+
+	/**
+	 * Return all products, as a set, or as a sequence in their order
+	 * of production. They are maintained incrementally, so that no
+	 * record is rescanned.
+	 */
 	HandleSet get_all_products() const;
-	HandleSet get_all_products();
+	HandleSeq get_products() const;
+
+	/**
+	 * Return the products produced since cursor, the number of
+	 * products already consumed by the caller, initially 0, and
+	 * advance cursor past them.
+	 */
+	HandleSeq get_new_products(size_t& cursor) const;
+
+	/**
+	 * Return the inference records kept in memory, oldest first.
+	 */
+	std::vector<InferenceRecord> get_inference_records() const;
 
 private:
-	std::vector<InferenceRecord> _inf_rec;
+	std::deque<InferenceRecord> _inf_rec;
+	int _record_limit;
+
+	// All products, as a set and in their order of production
+	HandleSet _products;
+	HandleSeq _product_seq;
+
+	ProductCallback _product_callback;
+
 	AtomSpace* _trace_as;
+	std::shared_ptr<TraceFile> _trace_file;
+	uint64_t _trace_run;
 
 	// TODO: subdivide in smaller and shared mutexes
 	mutable std::mutex _whole_mutex;
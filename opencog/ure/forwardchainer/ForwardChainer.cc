@@ -40,6 +40,9 @@
 
 #include "ForwardChainer.h"
 #include "../URELogger.h"
+#include "../URELogSink.h"
+#include "../UREProbes.h"
+#include "../RuleDependencyGraph.h"
 #include "../backwardchainer/ControlPolicy.h"
 #include "../ThompsonSampling.h"
 
@@ -57,7 +60,7 @@ ForwardChainer::ForwardChainer(AtomSpace& kb_as,
 	  _config(rb_as, rbs),
 	  _thread_count(0),
 	  _sources(_config, source, vardecl),
-	  _fcstat(trace_as),
+	  _fcstat(trace_as, ure_trace_file()),
 	  _srpi(true)
 {
 	init(source, vardecl, focus_set);
@@ -77,6 +80,9 @@ ForwardChainer::ForwardChainer(AtomSpace& kb_as,
 
 ForwardChainer::~ForwardChainer()
 {
+	// Write the pending log messages of that chainer, if asynchronous
+	if (ure_log_sink().is_async())
+		ure_log_sink().flush();
 }
 
 void ForwardChainer::init(const Handle& source,
@@ -105,6 +111,9 @@ void ForwardChainer::init(const Handle& source,
 
 	// Reset the iteration count
 	_iteration = 0;
+
+	_stats.set_enabled(_config.get_collect_stats());
+	_fcstat.set_record_limit(_config.get_inference_record_limit());
 }
 
 UREConfig& ForwardChainer::get_config()
@@ -119,8 +128,7 @@ const UREConfig& ForwardChainer::get_config() const
 
 void ForwardChainer::do_chain()
 {
-	ure_logger().debug("Start forward chaining");
-	LAZY_URE_LOG_DEBUG << "With rule set:" << std::endl << oc_to_string(_rules);
+	begin_chain();
 
 	// Relex2Logic uses this. TODO make a separate class to handle
 	// this robustly.
@@ -151,6 +159,21 @@ void ForwardChainer::do_chain()
 		ure_logger().set_thread_id_flag(prev_thread_id);
 	}
 
+	end_chain();
+}
+
+void ForwardChainer::begin_chain()
+{
+	ure_logger().debug("Start forward chaining");
+	LAZY_URE_LOG_DEBUG << "With rule set:" << std::endl << oc_to_string(_rules);
+
+	// The configuration may have been modified since construction
+	_stats.set_enabled(_config.get_collect_stats());
+	_fcstat.set_record_limit(_config.get_inference_record_limit());
+}
+
+void ForwardChainer::end_chain()
+{
 	// Log termination messages
 	termination_log();
 	LAZY_URE_LOG_DEBUG << "Finished forward chaining with results:"
@@ -200,16 +223,25 @@ void ForwardChainer::do_steps_srpi()
 	while (not termination()) do_step_srpi(_iteration++);
 }
 
+void ForwardChainer::do_step()
+{
+	if (_srpi)
+		do_step_srpi(_iteration++);
+	else
+		do_step(_iteration++);
+}
+
 void ForwardChainer::do_step(int iteration)
 {
 	int lipo = iteration + 1;
-	std::string msgprfx = std::string("[I-") + std::to_string(lipo) + "] ";
-	ure_logger().debug() << msgprfx << "Start iteration (" << lipo
-	                     << "/" << _config.get_maximum_iterations_str() << ")";
+	IterationPrefix msgprfx(lipo);
+	LAZY_URE_LOG_DEBUG << msgprfx << "Start iteration (" << lipo
+	                   << "/" << _config.get_maximum_iterations_str() << ")";
 
 	// Expand meta rules. This should probably be done on-the-fly in
 	// the select_rule method, but for now it's here
 	expand_meta_rules(msgprfx);
+	_stats.record_population(iteration, _sources.size());
 
 	// Select source
 	SourcePtr source = select_source(msgprfx);
@@ -226,7 +258,7 @@ void ForwardChainer::do_step(int iteration)
 	RulePtr rule = rule_prob.first;
 	double prob(rule_prob.second);
 	if (not rule->is_valid()) {
-		ure_logger().debug() << msgprfx << "No selected rule, abort iteration";
+		LAZY_URE_LOG_DEBUG << msgprfx << "No selected rule, abort iteration";
 		return;
 	} else {
 		LAZY_URE_LOG_DEBUG << msgprfx << "Selected rule, with probability " << prob
@@ -239,7 +271,10 @@ void ForwardChainer::do_step(int iteration)
 		HandleSet products = apply_rule(*rule);
 
 		// Insert the produced sources in the population of sources
-		_sources.insert(products, *source, prob, msgprfx);
+		{
+			ChainerStats::Timer timer(_stats, ChainerStats::SOURCE_INSERTION);
+			_sources.insert(products, *source, prob, msgprfx);
+		}
 
 		// The rule has been applied, we can set the exhausted flag
 		source->set_rule_exhausted(rule);
@@ -256,14 +291,17 @@ void ForwardChainer::do_step(int iteration)
 
 void ForwardChainer::do_step_srpi(int iteration)
 {
+	URE_PROBE1(fc_iteration_start, iteration);
+
 	int lipo = iteration + 1;
-	std::string msgprfx = std::string("[I-") + std::to_string(lipo) + "] ";
-	ure_logger().debug() << msgprfx << "Start iteration (" << lipo
-	                     << "/" << _config.get_maximum_iterations_str() << ")";
+	IterationPrefix msgprfx(lipo);
+	LAZY_URE_LOG_DEBUG << msgprfx << "Start iteration (" << lipo
+	                   << "/" << _config.get_maximum_iterations_str() << ")";
 
 	// Expand meta rules. This should probably be done on-the-fly in
 	// the select_rule method, but for now it's here.
 	expand_meta_rules(msgprfx);
+	_stats.record_population(iteration, _sources.size());
 
 	// Populate the source rule set
 	populate_source_rule_set(msgprfx);
@@ -276,6 +314,8 @@ void ForwardChainer::do_step_srpi(int iteration)
 		                   << "Selected source rule pair with probability "
 								 << success_plty << " of success:" << std::endl
 		                   << oc_to_string(slc_sr);
+		URE_PROBE1(fc_source_selected, slc_sr.source->body->get_hash());
+		URE_PROBE1(fc_rule_selected, slc_sr.rule->get_name().c_str());
 
 		// Apply selected source rule pair
 		HandleSet products = apply_rule(slc_sr);
@@ -290,7 +330,10 @@ void ForwardChainer::do_step_srpi(int iteration)
 		// replaced by do_step_srpi.
 		double weight = std::min(1.0, slc_sr.source->weight);
 		double prob = success_plty / weight;
-		_sources.insert(products, *slc_sr.source, prob, msgprfx);
+		{
+			ChainerStats::Timer timer(_stats, ChainerStats::SOURCE_INSERTION);
+			_sources.insert(products, *slc_sr.source, prob, msgprfx);
+		}
 
 		// The rule has been applied, we can set the exhausted flag
 		slc_sr.source->set_rule_exhausted(slc_sr.rule);
@@ -298,10 +341,12 @@ void ForwardChainer::do_step_srpi(int iteration)
 		// Save trace and results
 		_fcstat.add_inference_record(iteration, slc_sr.source->body,
 		                             *slc_sr.rule, products);
+		URE_PROBE2(fc_iteration_end, iteration, products.size());
 	} else {
 		LAZY_URE_LOG_DEBUG << msgprfx
 		                   << "Failed to select a source rule pair, "
 		                   << "abort iteration";
+		URE_PROBE2(fc_iteration_end, iteration, (size_t)0);
 	}
 }
 
@@ -336,7 +381,7 @@ void ForwardChainer::termination_log()
 		msg = "reach maximum number of iterations";
 	}
 
-	ure_logger().debug() << "Terminate: " << msg;
+	LAZY_URE_LOG_DEBUG << "Terminate: " << msg;
 }
 
 /**
@@ -355,11 +400,14 @@ void ForwardChainer::apply_all_rules()
 	}
 }
 
+int ForwardChainer::get_iteration() const
+{
+	return _iteration;
+}
+
 Handle ForwardChainer::get_results() const
 {
-	HandleSet rs = get_results_set();
-	HandleSeq results(rs.begin(), rs.end());
-	return _kb_as.add_link(SET_LINK, std::move(results));
+	return _kb_as.add_link(SET_LINK, _fcstat.get_products());
 }
 
 HandleSet ForwardChainer::get_results_set() const
@@ -367,15 +415,54 @@ HandleSet ForwardChainer::get_results_set() const
 	return _fcstat.get_all_products();
 }
 
-SourcePtr ForwardChainer::select_source(const std::string& msgprfx)
+HandleSeq ForwardChainer::get_new_results(size_t& cursor) const
 {
+	return _fcstat.get_new_products(cursor);
+}
+
+void ForwardChainer::set_result_callback(const ResultCallback& cb)
+{
+	_fcstat.set_product_callback(cb);
+}
+
+const ChainerStats& ForwardChainer::get_stats() const
+{
+	return _stats;
+}
+
+void ForwardChainer::prune_rules(const Handle& goal, const Handle& vardecl)
+{
+	std::lock_guard<std::mutex> lock(_rules_mutex);
+	size_t rules_size = _rules.size();
+	_rules = RuleDependencyGraph(_rules).relevant_rules(goal, vardecl);
+	LAZY_URE_LOG_DEBUG << "Rule pruning has kept " << _rules.size()
+	                   << "/" << rules_size << " rules";
+}
+
+void ForwardChainer::set_source_bias(const SourceBias& bias)
+{
+	_source_bias = bias;
+}
+
+void ForwardChainer::set_rule_bias(const RuleBias& bias)
+{
+	_rule_bias = bias;
+}
+
+SourcePtr ForwardChainer::select_source(const IterationPrefix& msgprfx)
+{
+	ChainerStats::Timer timer(_stats, ChainerStats::SOURCE_SELECTION);
+
 	// TODO: refine mutex
 	std::unique_lock<std::mutex> lock(_part_mutex);
 
 	std::vector<double> weights = _sources.get_weights();
+	if (_source_bias)
+		for (size_t i = 0; i < weights.size(); i++)
+			weights[i] *= _source_bias(_sources.sources[i]->body);
 
 	// Debug log
-	if (ure_logger().is_debug_enabled()) {
+	if (URE_LOG_DEBUG_ENABLED) {
 		OC_ASSERT(weights.size() == _sources.size());
 		size_t wi = 0;
 		// Sort sources according to their weights
@@ -383,14 +470,14 @@ SourcePtr ForwardChainer::select_source(const std::string& msgprfx)
 		for (size_t i = 0; i < weights.size(); i++) {
 			if (0 < weights[i]) {
 				wi++;
-				if (ure_logger().is_fine_enabled()) {
+				if (URE_LOG_FINE_ENABLED) {
 					weighted_sources.insert({weights[i], _sources.sources[i]->body});
 				}
 			}
 		}
 		LAZY_URE_LOG_DEBUG << msgprfx << "Positively weighted sources ("
 		                   << wi << "/" << weights.size() << ")";
-		if (ure_logger().is_fine_enabled()) {
+		if (URE_LOG_FINE_ENABLED) {
 			std::stringstream ws_ss;
 			for (const auto& wsp : boost::adaptors::reverse(weighted_sources))
 				ws_ss << std::endl << wsp.first << " " << wsp.second->id_to_string();
@@ -402,10 +489,10 @@ SourcePtr ForwardChainer::select_source(const std::string& msgprfx)
 	double total = boost::accumulate(weights, 0.0);
 
 	if (total == 0.0) {
-		ure_logger().debug() << msgprfx << "All sources have been exhausted";
+		LAZY_URE_LOG_DEBUG << msgprfx << "All sources have been exhausted";
 		if (_config.get_retry_exhausted_sources()) {
-			ure_logger().debug() << msgprfx
-			                     << "Reset all exhausted flags to retry them";
+			LAZY_URE_LOG_DEBUG << msgprfx
+			                   << "Reset all exhausted flags to retry them";
 			// TODO: This has the effect of deallocating the rules, which
 			// might cause a memory corruption if another thread is
 			// attempting to apply that rule at the same time.
@@ -424,7 +511,7 @@ SourcePtr ForwardChainer::select_source(const std::string& msgprfx)
 	return *std::next(_sources.sources.begin(), dist(randGen()));
 }
 
-SourceRule ForwardChainer::mk_source_rule(const std::string& msgprfx)
+SourceRule ForwardChainer::mk_source_rule(const IterationPrefix& msgprfx)
 {
 	SourcePtr source = select_source(msgprfx);
 	if (source) {
@@ -438,7 +525,7 @@ SourceRule ForwardChainer::mk_source_rule(const std::string& msgprfx)
 	const RuleSet valid_rules = get_valid_rules(*source);
 
 	// Log valid rules
-	if (ure_logger().is_debug_enabled()) {
+	if (URE_LOG_DEBUG_ENABLED) {
 		std::stringstream ss;
 		if (valid_rules.empty())
 			ss << msgprfx << "No valid rule for that source. Let's try again";
@@ -454,9 +541,24 @@ SourceRule ForwardChainer::mk_source_rule(const std::string& msgprfx)
 		return mk_source_rule(msgprfx);
 	}
 
-	// Thompson sample according to rule tvs
-	TruthValueSeq tvs = valid_rules.get_tvs();
-	RulePtr slc_rule = valid_rules[ThompsonSampling(tvs)()];
+	// Thompson sample according to rule tvs, or, if biased, sample
+	// the biased Thompson distribution, as select_rule does
+	RulePtr slc_rule;
+	{
+		ChainerStats::Timer timer(_stats, ChainerStats::THOMPSON_SELECTION);
+		TruthValueSeq tvs = valid_rules.get_tvs();
+		if (_rule_bias) {
+			std::vector<double> weights = ThompsonSampling(tvs).distribution();
+			size_t i = 0;
+			for (const RulePtr& rule : valid_rules)
+				weights[i++] *= _rule_bias(*rule);
+			std::discrete_distribution<size_t> dist(weights.begin(),
+			                                        weights.end());
+			slc_rule = rand_element(valid_rules, dist);
+		} else {
+			slc_rule = valid_rules[ThompsonSampling(tvs)()];
+		}
+	}
 	bool success = source->insert_rule(slc_rule);
 	if (not success)
 		return SourceRule();
@@ -470,8 +572,9 @@ SourceRule ForwardChainer::mk_source_rule(const std::string& msgprfx)
 	return sr;
 }
 
-void ForwardChainer::populate_source_rule_set(const std::string& msgprfx)
+void ForwardChainer::populate_source_rule_set(const IterationPrefix& msgprfx)
 {
+	ChainerStats::Timer timer(_stats, ChainerStats::POOL_POPULATION);
 	LAZY_URE_LOG_DEBUG << msgprfx << "Populate the source rule set (size="
 	                   << _source_rule_set.size() << ")";
 	int eps = _config.get_expansion_pool_size();
@@ -502,8 +605,9 @@ void ForwardChainer::populate_source_rule_set(const std::string& msgprfx)
 }
 
 std::pair<SourceRule, TruthValuePtr>
-ForwardChainer::select_source_rule(const std::string& msgprfx)
+ForwardChainer::select_source_rule(const IterationPrefix& msgprfx)
 {
+	ChainerStats::Timer timer(_stats, ChainerStats::THOMPSON_SELECTION);
 	return _source_rule_set.thompson_select();
 }
 
@@ -520,6 +624,7 @@ TruthValuePtr ForwardChainer::calculate_source_rule_tv(const SourceRule& sr)
 
 RuleSet ForwardChainer::get_valid_rules(const Source& source)
 {
+	ChainerStats::Timer timer(_stats, ChainerStats::UNIFICATION);
 	std::lock_guard<std::mutex> lock(_rules_mutex); // TODO: refine
 
 	// Generate all valid rules
@@ -559,19 +664,19 @@ RuleSet ForwardChainer::get_valid_rules(const Source& source)
 }
 
 RuleProbabilityPair ForwardChainer::select_rule(const Handle& h,
-                                                const std::string& msgprfx)
+                                                const IterationPrefix& msgprfx)
 {
 	Source src(h);
 	return select_rule(src, msgprfx);
 }
 
 RuleProbabilityPair ForwardChainer::select_rule(Source& source,
-                                                const std::string& msgprfx)
+                                                const IterationPrefix& msgprfx)
 {
 	const RuleSet valid_rules = get_valid_rules(source);
 
 	// Log valid rules
-	if (ure_logger().is_debug_enabled()) {
+	if (URE_LOG_DEBUG_ENABLED) {
 		std::stringstream ss;
 		if (valid_rules.empty())
 			ss << msgprfx << "No valid rule";
@@ -590,16 +695,23 @@ RuleProbabilityPair ForwardChainer::select_rule(Source& source,
 };
 
 RuleProbabilityPair ForwardChainer::select_rule(const RuleSet& valid_rules,
-                                                const std::string& msgprfx)
+                                                const IterationPrefix& msgprfx)
 {
+	ChainerStats::Timer timer(_stats, ChainerStats::THOMPSON_SELECTION);
+
 	// Build vector of all valid truth values
 	TruthValueSeq tvs = valid_rules.get_tvs();
 
 	// Build action selection distribution
 	std::vector<double> weights = ThompsonSampling(tvs).distribution();
+	if (_rule_bias) {
+		size_t i = 0;
+		for (const RulePtr& rule : valid_rules)
+			weights[i++] *= _rule_bias(*rule);
+	}
 
 	// Log the distribution
-	if (ure_logger().is_debug_enabled()) {
+	if (URE_LOG_DEBUG_ENABLED) {
 		std::stringstream ss;
 		ss << msgprfx << "Rule weights:";
 		size_t i = 0;
@@ -607,7 +719,7 @@ RuleProbabilityPair ForwardChainer::select_rule(const RuleSet& valid_rules,
 			ss << std::endl << weights[i] << " " << rule->get_name();
 			i++;
 		}
-		ure_logger().debug() << ss.str();
+		LAZY_URE_LOG_DEBUG << ss.str();
 	}
 
 	// Sample rules according to the weights
@@ -623,6 +735,8 @@ RuleProbabilityPair ForwardChainer::select_rule(const RuleSet& valid_rules,
 
 HandleSet ForwardChainer::apply_rule(const Rule& rule)
 {
+	ChainerStats::Timer timer(_stats, ChainerStats::RULE_APPLICATION);
+	URE_PROBE1(fc_apply_rule_start, rule.get_name().c_str());
 	HandleSet results;
 
 	// Take the results from applying the rule, add them in the given
@@ -652,20 +766,32 @@ HandleSet ForwardChainer::apply_rule(const Rule& rule)
 		derived_rule_as->clear_copy_on_write(); // _as should be write-through.
 		Handle rhcpy = derived_rule_as->add_atom(rule.get_rule());
 
-		// Make Sure that all constant clauses appear in the AtomSpace
-		// as unification might have created constant clauses which aren't
-		HandleSeq clauses = rule.get_clauses();
-		const HandleSet& varset = rule.get_variables().varset;
-		for (Handle clause : clauses)
-			if (is_constant(varset, clause))
-				if (ref_as.get_atom(clause) == Handle::UNDEFINED)
-					return results;
+		// Make sure that all clauses may have groundings in the
+		// AtomSpace, as unification might have created constant
+		// clauses, or clauses with constants, which aren't. Clauses
+		// are checked the most selective first.
+		if (rule.get_implicant()->get_type() != OR_LINK) {
+			ClausePlan plan = _clause_planner(rule.get_rule(),
+			                                  rule.get_clauses(),
+			                                  rule.get_variables().varset,
+			                                  ref_as);
+			if (plan.unsatisfiable()) {
+				LAZY_URE_LOG_DEBUG << "Rule " << rule.to_short_string()
+				                   << " cannot be satisfied, clause:"
+				                   << std::endl << oc_to_string(plan.clauses[0])
+				                   << "has no grounding";
+				URE_PROBE2(fc_apply_rule_end, rule.get_name().c_str(),
+				           results.size());
+				return results;
+			}
+		}
 
 		Handle h = HandleCast(rhcpy->execute(&ref_as));
 		add_results(ref_as, h->getOutgoingSet());
 	}
 	catch (...) {}
 
+	URE_PROBE2(fc_apply_rule_end, rule.get_name().c_str(), results.size());
 	return results;
 }
 
@@ -680,8 +806,9 @@ void ForwardChainer::validate(const Handle& source)
 		throw RuntimeException(TRACE_INFO, "ForwardChainer - Invalid source.");
 }
 
-void ForwardChainer::expand_meta_rules(const std::string& msgprfx)
+void ForwardChainer::expand_meta_rules(const IterationPrefix& msgprfx)
 {
+	ChainerStats::Timer timer(_stats, ChainerStats::META_RULE_EXPANSION);
 	std::lock_guard<std::mutex> lock(_rules_mutex);
 	// This is kinda of hack before meta rules are fully supported by
 	// the Rule class.
@@ -689,7 +816,7 @@ void ForwardChainer::expand_meta_rules(const std::string& msgprfx)
 	_rules.expand_meta_rules(_kb_as);
 
 	if (rules_size != _rules.size()) {
-		ure_logger().debug() << msgprfx << "The rule set has gone from "
-		                     << rules_size << " to " << _rules.size() << " rules";
+		LAZY_URE_LOG_DEBUG << msgprfx << "The rule set has gone from "
+		                   << rules_size << " to " << _rules.size() << " rules";
 	}
 }
@@ -24,10 +24,13 @@
 #ifndef _OPENCOG_FORWARDCHAINER_H_
 #define _OPENCOG_FORWARDCHAINER_H_
 
+#include <functional>
 #include <mutex>
 // #include <shared_mutex>
 
 #include "../UREConfig.h"
+#include "../ChainerStats.h"
+#include "../ClausePlanner.h"
 #include "SourceSet.h"
 #include "SourceRuleSet.h"
 #include "FCStat.h"
@@ -51,6 +54,16 @@ typedef std::pair<RulePtr, double> RuleProbabilityPair;
 class ForwardChainer
 {
 public:
+	// Factor of the weight of a source given its body, see
+	// set_source_bias
+	typedef std::function<double(const Handle&)> SourceBias;
+
+	// Factor of the weight of a rule, see set_rule_bias
+	typedef std::function<double(const Rule&)> RuleBias;
+
+	// Called on each new result, see set_result_callback
+	typedef FCStat::ProductCallback ResultCallback;
+
 	/**
 	 * Ctor.
 	 *
@@ -94,6 +107,22 @@ public:
 	 */
 	void do_chain();
 
+	/**
+	 * Prepare and wrap up forward chaining, that is everything
+	 * do_chain does besides stepping till termination. Useful to
+	 * step the chainer manually, for instance alongside another
+	 * chainer, with
+	 *
+	 * begin_chain();
+	 * while (not termination()) do_step();
+	 * end_chain();
+	 *
+	 * begin_chain applies the configuration modified since
+	 * construction, end_chain logs the termination.
+	 */
+	void begin_chain();
+	void end_chain();
+
 	/**
 	 * run steps (single or multi threaded) until termination criteria
 	 * are met.
@@ -112,6 +141,14 @@ public:
 	 */
 	void do_step(int iteration);
 
+	/**
+	 * Perform the next forward chaining inference step, using the
+	 * same implementation as do_chain. Calling it till termination is
+	 * equivalent to calling do_chain with a single job, over a
+	 * non-empty source.
+	 */
+	void do_step();
+
 	/**
 	 * Source rule producer implementation of do_step.
 	 */
@@ -122,6 +159,11 @@ public:
 	 */
 	bool termination();
 
+	/**
+	 * @return the number of iterations started so far.
+	 */
+	int get_iteration() const;
+
 	/**
 	 * Log the cause of termination
 	 */
@@ -133,6 +175,46 @@ public:
 	Handle get_results() const;
 	HandleSet get_results_set() const;
 
+	/**
+	 * Return the results produced since cursor, the number of results
+	 * already consumed by the caller, initially 0, and advance cursor
+	 * past them. Thread safe, thus can be used to poll the results
+	 * while do_chain is running in another thread.
+	 */
+	HandleSeq get_new_results(size_t& cursor) const;
+
+	/**
+	 * Set a callback called on each new result as soon as it is
+	 * produced, which allows to use results before do_chain returns.
+	 * If URE:jobs is greater than 1 the callback may be called
+	 * concurrently, thus must be thread safe.
+	 */
+	void set_result_callback(const ResultCallback& cb);
+
+	/**
+	 * @return the profiling counters, only recorded if
+	 * URE:collect-stats is true.
+	 */
+	const ChainerStats& get_stats() const;
+
+	/**
+	 * Set factors multiplying the selection weights of the sources,
+	 * given their bodies, and of the rules. Used to bias the search
+	 * toward some region, for instance by the bidirectional chainer.
+	 * The factors must be positive. Empty means no bias.
+	 */
+	void set_source_bias(const SourceBias& bias);
+	void set_rule_bias(const RuleBias& bias);
+
+	/**
+	 * Discard the rules that cannot contribute to produce the goal,
+	 * according to the rule dependency graph (see
+	 * RuleDependencyGraph::relevant_rules). Meant to be called before
+	 * do_chain, when only products matching the goal are of interest.
+	 */
+	void prune_rules(const Handle& goal,
+	                 const Handle& vardecl=Handle::UNDEFINED);
+
 private:
 	friend class ::ForwardChainerUTest;
 
@@ -149,7 +231,7 @@ private:
 	 *
 	 * @param msgprfx is a prefix to prepend before each log message.
 	 */
-	void expand_meta_rules(const std::string& msgprfx);
+	void expand_meta_rules(const IterationPrefix& msgprfx);
 
 	/**
 	 * choose next source to expand
@@ -159,24 +241,24 @@ private:
 	 * Warning: it is not const because the source is gonna be modified
 	 * by keeping track of the rules applied to it.
 	 */
-	SourcePtr select_source(const std::string& msgprfx);
+	SourcePtr select_source(const IterationPrefix& msgprfx);
 
 	/**
 	 * Build a source rule pair for application trial. If and only if
 	 * no such pair is available, then return an invalid pair.
 	 */
-	SourceRule mk_source_rule(const std::string& msgprfx);
+	SourceRule mk_source_rule(const IterationPrefix& msgprfx);
 
 	/**
 	 * Populate the source rule set with pairs
 	 */
-	void populate_source_rule_set(const std::string& msgprfx);
+	void populate_source_rule_set(const IterationPrefix& msgprfx);
 
 	/**
 	 * Select source rule pair
 	 */
 	std::pair<SourceRule, TruthValuePtr>
-	select_source_rule(const std::string& msgprfx);
+	select_source_rule(const IterationPrefix& msgprfx);
 
 	/**
 	 * Given a source rule pair, calculate its truth value of success.
@@ -200,11 +282,11 @@ private:
 	 * TODO: move to ControlPolicy
 	 */
 	RuleProbabilityPair select_rule(const Handle& source,
-	                                const std::string& msgprfx="");
+	                                const IterationPrefix& msgprfx=IterationPrefix());
 	RuleProbabilityPair select_rule(Source& source,
-	                                const std::string& msgprfx="");
+	                                const IterationPrefix& msgprfx=IterationPrefix());
 	RuleProbabilityPair select_rule(const RuleSet&,
-	                                const std::string& msgprfx="");
+	                                const IterationPrefix& msgprfx=IterationPrefix());
 
 	/**
 	 * Apply rule.
@@ -249,6 +331,9 @@ private:
 
 	FCStat _fcstat;
 
+	// Profiling counters
+	ChainerStats _stats;
+
 	// Enable alternative implementation using (source, rule) producer,
 	// srpi stands for Source Rule Producer Implementation. This flag
 	// is here, likely temporarily, to compare old and new way.
@@ -256,6 +341,14 @@ private:
 
 	// Set of weighted pairs (source, rule).
 	SourceRuleSet _source_rule_set;
+
+	// Estimate the selectivity of rule clauses, to discard rules that
+	// cannot be satisfied before applying them.
+	ClausePlanner _clause_planner;
+
+	// Bias of source and rule selection, if any
+	SourceBias _source_bias;
+	RuleBias _rule_bias;
 };
 
 } // ~namespace opencog
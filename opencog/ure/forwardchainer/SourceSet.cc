@@ -25,9 +25,13 @@
 #include <boost/range/algorithm/binary_search.hpp>
 #include <boost/range/algorithm/lower_bound.hpp>
 
+#include <opencog/util/algorithm.h>
 #include <opencog/util/numeric.h>
+#include <opencog/atoms/core/FindUtils.h>
 #include <opencog/atoms/core/VariableSet.h>
 
+#include "../Utils.h"
+
 namespace opencog {
 
 bool source_ptr_less::operator()(const SourcePtr& l, const SourcePtr& r) const
@@ -166,6 +170,13 @@ SourceSet::SourceSet(const UREConfig& config,
 				auto it = boost::lower_bound(sources, new_src, source_ptr_less());
 				sources.insert(it, new_src);
 			}
+
+			// Index the initial sources for subsumption pruning,
+			// unless their variable declaration is empty
+			if (not (init_vardecl and init_vardecl->is_link() and
+			         init_vardecl->get_arity() == 0))
+				for (const SourcePtr& src : sources)
+					_subsuming_sources[subsumption_key(*src)].push_back(src);
 		}
 	} else {
 		exhausted = true;
@@ -206,8 +217,32 @@ bool SourceSet::is_exhausted() const
 	return exhausted;
 }
 
+bool SourceSet::is_subsumed(const Source& src) const
+{
+	const SubsumptionKey undefined_key(NOTYPE, 0),
+		key(src.body->get_type(), src.body->get_arity());
+	for (const SubsumptionKey& k : {key, undefined_key}) {
+		auto it = _subsuming_sources.find(k);
+		if (it == _subsuming_sources.end())
+			continue;
+		for (const SourcePtr& other : it->second)
+			if (subsumes(other->body, src.body, other->vardecl))
+				return true;
+	}
+	return false;
+}
+
+SourceSet::SubsumptionKey SourceSet::subsumption_key(const Source& src)
+{
+	HandleSet vars = src.vardecl ? Variables(src.vardecl).varset
+		: get_free_variables(src.body);
+	if (contains(vars, src.body))
+		return SubsumptionKey(NOTYPE, 0);
+	return SubsumptionKey(src.body->get_type(), src.body->get_arity());
+}
+
 void SourceSet::insert(const HandleSet& products, const Source& src,
-                       double prob, const std::string& msgprfx)
+                       double prob, const IterationPrefix& msgprfx)
 {
 	std::lock_guard<std::mutex> lock(_mutex);
 	const static Handle empty_variable_set = Handle(createVariableSet(HandleSeq()));
@@ -227,6 +262,10 @@ void SourceSet::insert(const HandleSet& products, const Source& src,
 			LAZY_URE_LOG_FINE << msgprfx
 			                  << "The following source is already in the population: "
 			                  << new_src->body->id_to_string();
+		} else if (_config.get_subsumption_pruning() and is_subsumed(*new_src)) {
+			LAZY_URE_LOG_FINE << msgprfx
+			                  << "The following source is subsumed by the population: "
+			                  << new_src->body->id_to_string();
 		} else {
 			new_srcs.push_back(new_src);
 		}
@@ -240,7 +279,7 @@ void SourceSet::insert(const HandleSet& products, const Source& src,
 	}
 
 	// Log the new sources
-	if (ure_logger().is_debug_enabled()) {
+	if (URE_LOG_DEBUG_ENABLED) {
 		LAZY_URE_LOG_DEBUG << msgprfx
 		                   << products.size() << " results, including "
 		                   << new_srcs.size() << " new sources";
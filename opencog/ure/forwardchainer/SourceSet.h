@@ -24,6 +24,7 @@
 #ifndef _OPENCOG_SOURCESET_H_
 #define _OPENCOG_SOURCESET_H_
 
+#include <map>
 #include <vector>
 #include <mutex>
 
@@ -35,6 +36,7 @@
 
 #include "../Rule.h"
 #include "../UREConfig.h"
+#include "../URELogger.h"
 
 namespace opencog
 {
@@ -199,7 +201,7 @@ public:
 	 * for calculating complexity).
 	 */
 	void insert(const HandleSet& products, const Source& src,
-	            double prob, const std::string& msgprfx="");
+	            double prob, const IterationPrefix& msgprfx=IterationPrefix());
 
 	size_t size() const;
 
@@ -218,8 +220,24 @@ public:
 	bool exhausted;
 
 private:
+	/**
+	 * Return true iff src is an instance of a source of the
+	 * population, see subsumes in Utils.h. Used by insert to discard
+	 * new sources when URE:subsumption-pruning is enabled.
+	 */
+	bool is_subsumed(const Source& src) const;
+
 	const UREConfig& _config;
 
+	// Produced sources have an empty variable declaration, thus only
+	// the initial sources may subsume other sources. They are indexed
+	// by type and arity of their bodies, so that is_subsumed only
+	// compares a source to the ones of the same type and arity, or
+	// which body is a variable, indexed under NOTYPE.
+	typedef std::pair<Type, Arity> SubsumptionKey;
+	static SubsumptionKey subsumption_key(const Source& src);
+	std::map<SubsumptionKey, Sources> _subsuming_sources;
+
 	// TODO: subdivide in smaller and shared mutexes
 	mutable std::mutex _mutex;
 };
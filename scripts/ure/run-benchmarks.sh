@@ -0,0 +1,44 @@
+#!/bin/bash
+#
+# Run the URE benchmark sweep, from 10^3 to 10^6 facts and 10 to 1000
+# rules, over all workloads with both chainers, and output one JSON
+# object per run (JSON lines) on stdout.
+#
+# The benchmarks must be built first with
+#
+# make benchmarks
+#
+# Usage: run-benchmarks.sh [BUILD_DIR]
+#
+# Environment variables override the sweep, for instance
+#
+# FACTS="1000 10000" RULES=10 WORKLOADS=deduction run-benchmarks.sh
+
+# Check unbound variables
+set -u
+
+# Get the script directory
+PRG_PATH="$(readlink -f "$0")"
+PRG_DIR="$(dirname "$PRG_PATH")"
+BUILD_DIR="${1:-$PRG_DIR/../../build}"
+BENCHMARK="$BUILD_DIR/benchmarks/ure-benchmark"
+
+FACTS="${FACTS:-1000 10000 100000 1000000}"
+RULES="${RULES:-10 100 1000}"
+WORKLOADS="${WORKLOADS:-$("$BENCHMARK" --list)}"
+CHAINERS="${CHAINERS:-fc bc}"
+ITERATIONS="${ITERATIONS:-100}"
+SEED="${SEED:-0}"
+
+for workload in $WORKLOADS; do
+    for chainer in $CHAINERS; do
+        for facts in $FACTS; do
+            for rules in $RULES; do
+                echo "Run $workload $chainer with $facts facts and $rules rules" 1>&2
+                "$BENCHMARK" --workload "$workload" --chainer "$chainer" \
+                             --facts "$facts" --rules "$rules" \
+                             --iterations "$ITERATIONS" --seed "$SEED"
+            done
+        done
+    done
+done
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+
+# Convert a binary URE trace file, as written by the chainers after
+# calling cog-ure-set-trace-file!, into the scheme trace atoms that
+# FCStat and TraceRecorder would have added to the trace atomspace.
+# The output can then be loaded into an atomspace with
+#
+# (load "trace.scm")
+#
+# See opencog/ure/TraceFile.h for the description of the format.
+
+import mmap
+import struct
+import sys
+
+#############
+# Constants #
+#############
+
+# Usage message
+usage = "Usage: " + sys.argv[0] + " TRACEFILE [RUN]\n\n" \
+    "Output the trace atoms of all runs, or only the RUN-th one (starting\n" \
+    "from 1, in order of appearance in TRACEFILE)."
+
+magic = b'URETRACE'
+version = 2
+
+# Record types
+ATOM = 1
+RUN = 2
+FC_INFERENCE = 3
+BC_TARGET = 4
+BC_ANDBIT = 5
+BC_EXPANSION = 6
+BC_PROOF = 7
+
+# Run kinds
+run_kinds = {0: "forward", 1: "backward"}
+
+header = struct.Struct('=BQI')
+uint32 = struct.Struct('=I')
+uint64 = struct.Struct('=Q')
+
+#############
+# Functions #
+#############
+
+def records(data):
+    """Yield (type, run, payload) for each record of data"""
+    if data[:len(magic)] != magic:
+        raise ValueError("Not a URE trace file")
+    file_version = uint32.unpack_from(data, len(magic))[0]
+    if file_version != version:
+        raise ValueError("Unsupported URE trace file version {}"
+                         .format(file_version))
+    offset = len(magic) + uint32.size
+    while offset + header.size <= len(data):
+        rtype, run, size = header.unpack_from(data, offset)
+        offset += header.size
+        yield rtype, run, data[offset:offset + size]
+        offset += size
+
+def hashes(payload, offset, count):
+    return struct.unpack_from('={}Q'.format(count), payload, offset)
+
+def dont_exec(atom):
+    return "(DontExecLink {})".format(atom)
+
+def fc_inference(atoms, payload):
+    iteration, rule, source, count = struct.unpack_from('=IQQI', payload)
+    products = hashes(payload, struct.calcsize('=IQQI'), count)
+    inputs = "(ListLink {} (NumberNode \"{}\"))".format(atoms[source],
+                                                      iteration + 1)
+    return ["(ExecutionLink {} {} {})".format(atoms[rule], inputs,
+                                              atoms[product])
+            for product in products]
+
+def bc_target(atoms, payload):
+    target = hashes(payload, 0, 1)[0]
+    return ["(EvaluationLink (stv 1 1) (PredicateNode \"URE:BC:target\") {})"
+            .format(atoms[target])]
+
+def bc_andbit(atoms, payload):
+    fcs = hashes(payload, 0, 1)[0]
+    return ["(EvaluationLink (stv 1 1) (PredicateNode \"URE:BC:and-BIT\") {})"
+            .format(dont_exec(atoms[fcs]))]
+
+def bc_expansion(atoms, payload):
+    fcs, body, rule, new_fcs = hashes(payload, 0, 4)
+    inputs = "(ListLink {} {} {})".format(dont_exec(atoms[fcs]), atoms[body],
+                                         dont_exec(atoms[rule]))
+    return ["(ExecutionLink (stv 1 1) (SchemaNode \"URE:BC:expand-and-BIT\") "
+            "{} {})".format(inputs, dont_exec(atoms[new_fcs]))]
+
+def bc_proof(atoms, payload):
+    fcs, result, strength, confidence = struct.unpack_from('=QQdd', payload)
+    return ["(EvaluationLink (stv {} {}) (PredicateNode \"URE:BC:proof-of\") "
+            "(ListLink {} {}))".format(strength, confidence,
+                                       dont_exec(atoms[fcs]), atoms[result])]
+
+converters = {FC_INFERENCE: fc_inference,
+              BC_TARGET: bc_target,
+              BC_ANDBIT: bc_andbit,
+              BC_EXPANSION: bc_expansion,
+              BC_PROOF: bc_proof}
+
+def convert(data, selected_run, out):
+    atoms = {}
+    # Map the run identifiers of the records to their rank in the
+    # file
+    ranks = {}
+    run_count = 0
+    for rtype, run, payload in records(data):
+        if rtype == ATOM:
+            atom_hash = uint64.unpack_from(payload)[0]
+            atom = payload[uint64.size:].decode('utf-8').strip()
+            # Atoms are only identified by their hashes, see TraceFile.h
+            if atoms.get(atom_hash, atom) != atom:
+                raise ValueError("Hash collision between atoms {} and {}"
+                                 .format(atoms[atom_hash], atom))
+            atoms[atom_hash] = atom
+        elif rtype == RUN:
+            run_count += 1
+            ranks[run] = run_count
+            if selected_run in (None, run_count):
+                out.write("\n;; Run {} ({} chainer)\n"
+                          .format(run_count, run_kinds.get(payload[0], "?")))
+        elif rtype in converters:
+            if selected_run in (None, ranks.get(run)):
+                for atom in converters[rtype](atoms, payload):
+                    out.write(atom + "\n")
+
+########
+# Main #
+########
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print(usage)
+        sys.exit(1)
+
+    selected_run = int(sys.argv[2]) if len(sys.argv) == 3 else None
+    with open(sys.argv[1], 'rb') as f:
+        data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        try:
+            convert(data, selected_run, sys.stdout)
+        finally:
+            data.close()
+
+if __name__ == "__main__":
+    main()
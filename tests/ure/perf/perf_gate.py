@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+#
+# Performance regression gate of the URE.
+#
+# Run a fixed-seed subset of the ure-benchmark workloads, each in its
+# own process and several times, keep the best measures, and compare
+# them against a checked-in baseline. Fail if
+#
+# 1. the number of iterations or results differs from the baseline,
+#    meaning that the behavior, thus the measures, have changed,
+# 2. the throughput (iterations per second) is lower than the baseline
+#    beyond the tolerance,
+# 3. the peak resident set size is higher than the baseline beyond
+#    the tolerance.
+#
+# Runs without baseline measures fail as well, record the baseline of
+# the reference machine with --update.
+#
+# Usage: perf_gate.py --benchmark BENCHMARK --baseline BASELINE
+#                     [--repeat N] [--tolerance T] [--update]
+#
+# The tolerance may also be overridden with the URE_PERF_TOLERANCE
+# environment variable, for instance on noisy machines.
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+# Metrics compared with a tolerance, and whether higher is better
+TOLERATED_METRICS = {"iterations_per_second": True,
+                     "peak_rss_kb": False}
+
+# Metrics that must be equal
+EXACT_METRICS = ["iterations", "results"]
+
+
+def run_benchmark(benchmark, run):
+    """Run a workload and return its measures as a dict."""
+    cmd = [benchmark,
+           "--workload", run["workload"],
+           "--chainer", run["chainer"],
+           "--facts", str(run["facts"]),
+           "--rules", str(run["rules"]),
+           "--iterations", str(run["iterations"]),
+           "--seed", str(run["seed"])]
+    out = subprocess.run(cmd, check=True, stdout=subprocess.PIPE,
+                         universal_newlines=True).stdout
+    return json.loads(out.strip().splitlines()[-1])
+
+
+def best_measures(benchmark, run, repeat):
+    """Run a workload repeat times and return its best measures."""
+    measures = [run_benchmark(benchmark, run) for _ in range(repeat)]
+    best = dict(measures[0])
+    for metric, higher_is_better in TOLERATED_METRICS.items():
+        select = max if higher_is_better else min
+        best[metric] = select(m[metric] for m in measures)
+    return best
+
+
+def run_name(run):
+    return "{workload}/{chainer} ({facts} facts, {rules} rules)".format(**run)
+
+
+def compare(run, current, tolerances):
+    """Return the rows of the comparison report, and whether it fails."""
+    expected = run.get("expected", {})
+    rows, failed = [], False
+    for metric in EXACT_METRICS:
+        base = expected.get(metric)
+        if base is None:
+            rows.append((metric, "-", current[metric], "", "FAIL (no baseline)"))
+            failed = True
+        elif current[metric] != base:
+            rows.append((metric, base, current[metric], "", "FAIL (changed)"))
+            failed = True
+        else:
+            rows.append((metric, base, current[metric], "", "ok"))
+    for metric, higher_is_better in TOLERATED_METRICS.items():
+        base = expected.get(metric)
+        cur = current[metric]
+        if base is None:
+            rows.append((metric, "-", cur, "", "FAIL (no baseline)"))
+            failed = True
+            continue
+        change = (cur - base) / base if base else 0.0
+        tol = tolerances[metric]
+        worse = -change if higher_is_better else change
+        status = "ok"
+        if tol < worse:
+            status = "FAIL (tolerance {:.0%})".format(tol)
+            failed = True
+        rows.append((metric, base, cur, "{:+.1%}".format(change), status))
+    return rows, failed
+
+
+def print_report(name, rows):
+    print(name)
+    header = ("metric", "baseline", "current", "change", "status")
+    table = [header] + [tuple(str(c) for c in row) for row in rows]
+    widths = [max(len(row[i]) for row in table) for i in range(len(header))]
+    for row in table:
+        print(("  " + "  ".join(c.ljust(w) for c, w in zip(row, widths))).rstrip())
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="URE performance gate")
+    parser.add_argument("--benchmark", required=True,
+                        help="path of the ure-benchmark executable")
+    parser.add_argument("--baseline", required=True,
+                        help="path of the baseline JSON file")
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="number of runs per workload (default 3)")
+    parser.add_argument("--tolerance", type=float, default=None,
+                        help="override the tolerances of the baseline")
+    parser.add_argument("--update", action="store_true",
+                        help="record the current measures as baseline")
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+
+    tolerances = dict(baseline["tolerances"])
+    tolerance = args.tolerance
+    if tolerance is None and "URE_PERF_TOLERANCE" in os.environ:
+        tolerance = float(os.environ["URE_PERF_TOLERANCE"])
+    if tolerance is not None:
+        tolerances = {metric: tolerance for metric in tolerances}
+
+    failures = []
+    for run in baseline["runs"]:
+        current = best_measures(args.benchmark, run, args.repeat)
+        if args.update:
+            run["expected"] = {metric: current[metric] for metric in
+                               EXACT_METRICS + list(TOLERATED_METRICS)}
+            continue
+        rows, failed = compare(run, current, tolerances)
+        print_report(run_name(run), rows)
+        if failed:
+            failures.append(run_name(run))
+
+    if args.update:
+        with open(args.baseline, "w") as f:
+            json.dump(baseline, f, indent=2)
+            f.write("\n")
+        print("Updated baseline " + args.baseline)
+        return 0
+
+    if failures:
+        print("Performance regression in:")
+        for name in failures:
+            print("  " + name)
+        return 1
+    print("No performance regression")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())